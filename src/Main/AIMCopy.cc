@@ -163,6 +163,13 @@ bool AIMCopy::Process() {
   for (unsigned int i = 0; i < script_.size(); ++i) {
     global_parameters_.SetString("input_filename", script_[i].first.c_str());
     global_parameters_.SetString("output_filename_base", script_[i].second.c_str());
+    // Lets the input start reading the next file ahead of time
+    if (i + 1 < script_.size()) {
+      global_parameters_.SetString("next_input_filename",
+                                   script_[i + 1].first.c_str());
+    } else {
+      global_parameters_.SetString("next_input_filename", "");
+    }
     if (!tree_initialized) {
       if (!tree_.Initialize(&global_parameters_)) {
         return false;
@@ -179,6 +186,7 @@ bool AIMCopy::Process() {
   // A final call to Reset() is required to close any open files.
   global_parameters_.SetString("input_filename", "");
   global_parameters_.SetString("output_filename_base", "");
+  global_parameters_.SetString("next_input_filename", "");
   tree_.Reset();
   return true;
 }
@@ -175,6 +175,7 @@ bool ModuleGammatone::InitializeInternal(const SignalBank& input) {
 }
 
 void ModuleGammatone::Process(const SignalBank &input) {
+  output_.SetBufferLength(input.buffer_length());
   output_.set_start_time(input.start_time());
   int audio_channel = 0;
 
@@ -558,8 +558,9 @@ inline float ModulePZFC::Minimum(float a, float b) {
 }
 
 void ModulePZFC::Process(const SignalBank& input) {
-  // Set the start time of the output buffer
+  // Set the start time and length of the output buffer
   output_.set_start_time(input.start_time());
+  output_.SetBufferLength(input.buffer_length());
 
   for (int s = 0; s < input.buffer_length(); ++s) {
     float input_sample = input.sample(0, s);
@@ -44,6 +44,8 @@ bool ModuleBoxes::InitializeInternal(const SignalBank &input) {
   buffer_length_ = input.buffer_length();
   channel_count_ = input.channel_count();
 
+  box_limits_channels_.clear();
+  box_limits_time_.clear();
   int channels_height = box_size_spectral_;
   while (channels_height < channel_count_ / 2) {
     int top = channel_count_ - 1;
@@ -63,6 +65,30 @@ bool ModuleBoxes::InitializeInternal(const SignalBank &input) {
     temporal_width *= 2;
   }
 
+  // Size of a pixel in each band of channels and each temporal width.
+  // Only the whole pixels are included in a box.
+  pixel_size_channels_.clear();
+  for (unsigned int c = 0; c < box_limits_channels_.size(); ++c) {
+    pixel_size_channels_.push_back((box_limits_channels_[c].first
+                                    - box_limits_channels_[c].second)
+                                   / box_size_spectral_);
+  }
+  pixel_size_samples_.clear();
+  for (unsigned int s = 0; s < box_limits_time_.size(); ++s) {
+    pixel_size_samples_.push_back(box_limits_time_[s] / box_size_temporal_);
+  }
+
+  // The summed-area table only needs to cover the samples which fall into
+  // the widest boxes
+  integral_width_ = 0;
+  if (!box_limits_time_.empty()) {
+    integral_width_ = box_size_temporal_ * pixel_size_samples_.back();
+  }
+  integral_image_.resize((channel_count_ + 1) * (integral_width_ + 1));
+  for (int i = 0; i < static_cast<int>(integral_image_.size()); ++i) {
+    integral_image_[i] = 0.0;
+  }
+
   box_count_ = box_limits_time_.size() * box_limits_channels_.size();
   feature_size_ = box_size_spectral_ + box_size_temporal_;
   LOG_INFO("Total box count is %d", box_count_);
@@ -92,49 +118,50 @@ void ModuleBoxes::Process(const SignalBank &input) {
     return;
   }
 
+  // Build the summed-area table of the image. Entry (c, l) is the sum of
+  // all samples in channels below c and at times before l.
+  int stride = integral_width_ + 1;
+  for (int c = 0; c < channel_count_; ++c) {
+    const double *previous_row = &integral_image_[c * stride];
+    double *row = &integral_image_[(c + 1) * stride];
+    const vector<float> &signal = input[c];
+    double row_sum = 0.0;
+    for (int l = 0; l < integral_width_; ++l) {
+      row_sum += signal[l];
+      row[l + 1] = previous_row[l + 1] + row_sum;
+    }
+  }
+
+  // Each pixel of a box is the mean of a rectangle of the image, and each
+  // feature is the mean of a row or column of pixels, which is again a
+  // rectangle. So every feature is a single four-corner lookup.
   int box_index = 0;
   for (int c = 0; c < static_cast<int>(box_limits_channels_.size()); ++c) {
+    int pixel_size_channels = pixel_size_channels_[c];
+    int bottom = box_limits_channels_[c].second;
+    int box_height = pixel_size_channels * box_size_spectral_;
     for (int s = 0; s < static_cast<int>(box_limits_time_.size()); ++s) {
-      int pixel_size_channels = (box_limits_channels_[c].first
-                                 - box_limits_channels_[c].second)
-                                   / box_size_spectral_;
-      int pixel_size_samples = box_limits_time_[s] / box_size_temporal_;
-      vector<vector<float> > box;
-      vector<float> line;
-      line.resize(box_size_temporal_, 0.0f);
-      box.resize(box_size_spectral_, line);
-      for (int i = 0; i < box_size_spectral_; ++i) {
-        for (int j = 0; j < box_size_temporal_; ++j) {
-          float pixel_value = 0.0f;
-          for (int k = i * pixel_size_channels;
-               k < (i + 1) * pixel_size_channels; ++k) {
-            for (int l = j * pixel_size_samples;
-                 l < (j + 1) * pixel_size_samples; ++l) {
-              pixel_value += input.sample(k
-                                          + box_limits_channels_[c].second, l);
-            }
-          }
-          pixel_value /= (pixel_size_channels * pixel_size_samples);
-          box[i][j] = pixel_value;
-        }
-      }
+      int pixel_size_samples = pixel_size_samples_[s];
+      int box_width = pixel_size_samples * box_size_temporal_;
       int feature_index = 0;
+
+      // Spectral profile of the box: the mean of each row of pixels
+      float scale = 1.0f / (box_width * pixel_size_channels);
       for (int i = 0; i < box_size_spectral_; ++i) {
-        float feature_value = 0.0f;
-        for (int j = 0; j < box_size_temporal_; ++j) {
-          feature_value += box[i][j];
-        }
-        feature_value /= box_size_temporal_;
-        output_.set_sample(box_index, feature_index, feature_value);
+        int row_start = bottom + i * pixel_size_channels;
+        double sum = RectangleSum(row_start, row_start + pixel_size_channels,
+                                  0, box_width);
+        output_.set_sample(box_index, feature_index, sum * scale);
         ++feature_index;
       }
+
+      // Temporal profile of the box: the mean of each column of pixels
+      scale = 1.0f / (box_height * pixel_size_samples);
       for (int j = 0; j < box_size_temporal_; ++j) {
-        float feature_value = 0.0f;
-        for (int i = 0; i < box_size_spectral_; ++i) {
-          feature_value += box[i][j];
-        }
-        feature_value /= box_size_spectral_;
-        output_.set_sample(box_index, feature_index, feature_value);
+        int column_start = j * pixel_size_samples;
+        double sum = RectangleSum(bottom, bottom + box_height, column_start,
+                                  column_start + pixel_size_samples);
+        output_.set_sample(box_index, feature_index, sum * scale);
         ++feature_index;
       }
       ++box_index;
@@ -143,4 +170,13 @@ void ModuleBoxes::Process(const SignalBank &input) {
 
   PushOutput();
 }
+
+double ModuleBoxes::RectangleSum(int channel_start, int channel_end,
+                                 int sample_start, int sample_end) const {
+  int stride = integral_width_ + 1;
+  return integral_image_[channel_end * stride + sample_end]
+         - integral_image_[channel_start * stride + sample_end]
+         - integral_image_[channel_end * stride + sample_start]
+         + integral_image_[channel_start * stride + sample_start];
+}
 }  // namespace aimc
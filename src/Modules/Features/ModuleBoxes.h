@@ -50,6 +50,12 @@ class ModuleBoxes : public Module {
    */
   virtual bool InitializeInternal(const SignalBank &input);
 
+  /*! \brief Sum of the image over channels [channel_start, channel_end) and
+   *  samples [sample_start, sample_end), from the summed-area table
+   */
+  double RectangleSum(int channel_start, int channel_end,
+                      int sample_start, int sample_end) const;
+
   float sample_rate_;
   int buffer_length_;
   int channel_count_;
@@ -59,6 +65,18 @@ class ModuleBoxes : public Module {
   vector<pair<int, int> > box_limits_channels_;
   int box_count_;
   int feature_size_;
+
+  /*! \brief Size of a box pixel in channels for each entry of
+   *  box_limits_channels_, and in samples for each entry of box_limits_time_
+   */
+  vector<int> pixel_size_channels_;
+  vector<int> pixel_size_samples_;
+
+  /*! \brief Summed-area table of the current image, with
+   *  (channel_count_ + 1) rows of (integral_width_ + 1) entries
+   */
+  vector<double> integral_image_;
+  int integral_width_;
 };
 }  // namespace aimc
 
@@ -0,0 +1,379 @@
+// Copyright 2026, agent
+//
+// AIM-C: A C++ implementation of the Auditory Image Model
+// http://www.acousticscale.org/AIMC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*!
+ * \author agent <agent@local>
+ * \date created 2026/10/19
+ * \version \$Id$
+ */
+
+#include <math.h>
+
+#include <algorithm>
+#include <string>
+
+#include "Modules/Features/ModuleDeltas.h"
+
+namespace aimc {
+using std::max;
+using std::min;
+using std::string;
+
+// Normalisation window half-width used for utterance-level normalisation.
+// Large enough to cover any utterance, small enough not to overflow when
+// added to a frame number.
+static const int kUtteranceHalfWindow = 1 << 28;
+
+// Smallest variance used for variance normalisation
+static const double kVarianceFloor = 1e-10;
+
+ModuleDeltas::ModuleDeltas(Parameters *params) : Module(params) {
+  module_description_ = "Feature normalisation with deltas and accelerations";
+  module_identifier_ = "deltas";
+  module_type_ = "features";
+  module_version_ = "$Id$";
+
+  // Mean normalisation of the input features:
+  // "none" - no normalisation
+  // "utterance" - over the whole input file. The output is delayed until
+  //   the end of the file.
+  // "sliding" - over a window of deltas.normalize_window frames centred on
+  //   each frame, with a lookahead of half the window
+  string normalize = parameters_->DefaultString("deltas.normalize", "none");
+  int normalize_window = parameters_->DefaultInt("deltas.normalize_window",
+                                                 300);
+  normalize_variance_ = parameters_->DefaultBool(
+      "deltas.normalize_variance", true);
+  normalize_ = true;
+  normalize_half_window_ = 0;
+  if (normalize.compare("utterance") == 0) {
+    normalize_half_window_ = kUtteranceHalfWindow;
+  } else if (normalize.compare("sliding") == 0) {
+    normalize_half_window_ = max(normalize_window / 2, 1);
+  } else {
+    if (normalize.compare("none") != 0) {
+      LOG_ERROR(_T("Unknown normalisation '%s'. Not normalising."),
+                normalize.c_str());
+    }
+    normalize_ = false;
+  }
+
+  // Regression windows for the delta and acceleration coefficients, which
+  // are appended to the (normalised) input features. As in HTK, the
+  // accelerations are the deltas of the deltas. Set to 0 to disable.
+  delta_window_ = parameters_->DefaultInt("deltas.delta_window", 2);
+  accel_window_ = parameters_->DefaultInt("deltas.accel_window", 2);
+  if (delta_window_ < 0) {
+    delta_window_ = 0;
+  }
+  if (accel_window_ < 0 || delta_window_ == 0) {
+    accel_window_ = 0;
+  }
+}
+
+ModuleDeltas::~ModuleDeltas() {
+}
+
+bool ModuleDeltas::InitializeInternal(const SignalBank &input) {
+  // Copy the parameters of the input signal bank into internal variables, so
+  // that they can be checked later.
+  sample_rate_ = input.sample_rate();
+  buffer_length_ = input.buffer_length();
+  channel_count_ = input.channel_count();
+  feature_count_ = channel_count_ * buffer_length_;
+
+  // The output has the static features, followed by blocks of the same
+  // shape for the deltas and the accelerations
+  int block_count = 1;
+  if (delta_window_ > 0) {
+    ++block_count;
+  }
+  if (accel_window_ > 0) {
+    ++block_count;
+  }
+  output_.Initialize(block_count * channel_count_, buffer_length_,
+                     sample_rate_);
+  for (int b = 0; b < block_count; ++b) {
+    for (int ch = 0; ch < channel_count_; ++ch) {
+      output_.set_centre_frequency(b * channel_count_ + ch,
+                                   input.centre_frequency(ch));
+    }
+  }
+
+  raw_frames_.clear();
+  start_times_.clear();
+  pitch_indices_.clear();
+  statics_.clear();
+  deltas_.clear();
+  accels_.clear();
+  window_sum_.assign(feature_count_, 0.0);
+  window_sum_squares_.assign(feature_count_, 0.0);
+  raw_first_ = 0;
+  raw_count_ = 0;
+  window_start_ = 0;
+  window_end_ = 0;
+  statics_first_ = 0;
+  statics_count_ = 0;
+  deltas_first_ = 0;
+  deltas_count_ = 0;
+  accels_first_ = 0;
+  accels_count_ = 0;
+  output_count_ = 0;
+  return true;
+}
+
+void ModuleDeltas::ResetInternal() {
+  // The frames still waiting for lookahead belong to the input that has just
+  // ended
+  ProcessFrames(true);
+
+  raw_frames_.clear();
+  start_times_.clear();
+  pitch_indices_.clear();
+  statics_.clear();
+  deltas_.clear();
+  accels_.clear();
+  raw_first_ = 0;
+  raw_count_ = 0;
+  window_sum_.assign(feature_count_, 0.0);
+  window_sum_squares_.assign(feature_count_, 0.0);
+  window_start_ = 0;
+  window_end_ = 0;
+  statics_first_ = 0;
+  statics_count_ = 0;
+  deltas_first_ = 0;
+  deltas_count_ = 0;
+  accels_first_ = 0;
+  accels_count_ = 0;
+  output_count_ = 0;
+}
+
+void ModuleDeltas::Process(const SignalBank &input) {
+  // Check to see if the module has been initialized. If not, processing
+  // should not continue.
+  if (!initialized_) {
+    LOG_ERROR(_T("Module %s not initialized."), module_identifier_.c_str());
+    return;
+  }
+
+  // Check that ths input this time is the same as the input passed to
+  // Initialize()
+  if (buffer_length_ != input.buffer_length()
+      || channel_count_ != input.channel_count()) {
+    LOG_ERROR(_T("Mismatch between input to Initialize() and input to "
+                 "Process() in module %s."), module_identifier_.c_str());
+    return;
+  }
+
+  raw_frames_.push_back(vector<float>(feature_count_));
+  vector<float> &frame = raw_frames_.back();
+  for (int ch = 0; ch < channel_count_; ++ch) {
+    const vector<float> &signal = input[ch];
+    for (int i = 0; i < buffer_length_; ++i) {
+      frame[ch * buffer_length_ + i] = signal[i];
+    }
+  }
+  ++raw_count_;
+  start_times_.push_back(input.start_time());
+  pitch_indices_.push_back(input.pitch_index());
+
+  ProcessFrames(false);
+}
+
+void ModuleDeltas::ProcessFrames(bool finishing) {
+  // Normalised static features
+  int lookahead = normalize_ ? normalize_half_window_ : 0;
+  while (statics_count_ < raw_count_
+         && (finishing || raw_count_ > statics_count_ + lookahead)) {
+    statics_.push_back(vector<float>(feature_count_));
+    if (normalize_) {
+      NormalizeFrame(statics_count_, &statics_.back());
+    } else {
+      statics_.back() = raw_frames_[statics_count_ - raw_first_];
+    }
+    ++statics_count_;
+  }
+
+  // Deltas
+  if (delta_window_ > 0) {
+    while (deltas_count_ < statics_count_
+           && (finishing || statics_count_ > deltas_count_ + delta_window_)) {
+      deltas_.push_back(vector<float>(feature_count_));
+      ComputeDeltas(statics_, statics_first_, statics_count_, deltas_count_,
+                    delta_window_, &deltas_.back());
+      ++deltas_count_;
+    }
+  }
+
+  // Accelerations
+  if (accel_window_ > 0) {
+    while (accels_count_ < deltas_count_
+           && (finishing || deltas_count_ > accels_count_ + accel_window_)) {
+      accels_.push_back(vector<float>(feature_count_));
+      ComputeDeltas(deltas_, deltas_first_, deltas_count_, accels_count_,
+                    accel_window_, &accels_.back());
+      ++accels_count_;
+    }
+  }
+
+  // A frame can be output once its last set of coefficients is available
+  int ready_count = statics_count_;
+  if (accel_window_ > 0) {
+    ready_count = accels_count_;
+  } else if (delta_window_ > 0) {
+    ready_count = deltas_count_;
+  }
+  while (output_count_ < ready_count) {
+    OutputFrame();
+    ++output_count_;
+  }
+
+  TrimFrames();
+}
+
+void ModuleDeltas::NormalizeFrame(int frame, vector<float> *output) {
+  // Slide the window to cover the frames around this one which are
+  // available. Both ends only ever move forwards.
+  int window_start = max(frame - normalize_half_window_, 0);
+  int window_end = min(frame + normalize_half_window_ + 1, raw_count_);
+  for (; window_end_ < window_end; ++window_end_) {
+    const vector<float> &added = raw_frames_[window_end_ - raw_first_];
+    for (int k = 0; k < feature_count_; ++k) {
+      window_sum_[k] += added[k];
+      window_sum_squares_[k] += added[k] * added[k];
+    }
+  }
+  for (; window_start_ < window_start; ++window_start_) {
+    const vector<float> &removed = raw_frames_[window_start_ - raw_first_];
+    for (int k = 0; k < feature_count_; ++k) {
+      window_sum_[k] -= removed[k];
+      window_sum_squares_[k] -= removed[k] * removed[k];
+    }
+  }
+
+  const vector<float> &input = raw_frames_[frame - raw_first_];
+  double frame_count = window_end_ - window_start_;
+  for (int k = 0; k < feature_count_; ++k) {
+    double mean = window_sum_[k] / frame_count;
+    double value = input[k] - mean;
+    if (normalize_variance_) {
+      double variance = window_sum_squares_[k] / frame_count - mean * mean;
+      if (variance < kVarianceFloor) {
+        variance = kVarianceFloor;
+      }
+      value /= sqrt(variance);
+    }
+    (*output)[k] = value;
+  }
+}
+
+void ModuleDeltas::ComputeDeltas(const deque<vector<float> > &frames,
+                                 int first, int count, int frame, int window,
+                                 vector<float> *output) const {
+  // d_t = sum_{i=1}^{W} i (c_{t+i} - c_{t-i}) / (2 sum_{i=1}^{W} i^2)
+  float denominator = 0.0f;
+  for (int i = 1; i <= window; ++i) {
+    denominator += i * i;
+  }
+  denominator *= 2.0f;
+
+  vector<float> &delta = *output;
+  for (int k = 0; k < feature_count_; ++k) {
+    delta[k] = 0.0f;
+  }
+  for (int i = 1; i <= window; ++i) {
+    const vector<float> &next = frames[min(frame + i, count - 1) - first];
+    const vector<float> &previous = frames[max(frame - i, 0) - first];
+    for (int k = 0; k < feature_count_; ++k) {
+      delta[k] += i * (next[k] - previous[k]);
+    }
+  }
+  for (int k = 0; k < feature_count_; ++k) {
+    delta[k] /= denominator;
+  }
+}
+
+void ModuleDeltas::OutputFrame() {
+  output_.set_start_time(start_times_.front());
+  output_.set_pitch_index(pitch_indices_.front());
+  start_times_.pop_front();
+  pitch_indices_.pop_front();
+
+  int block = 0;
+  const vector<float> *blocks[3];
+  blocks[block++] = &statics_[output_count_ - statics_first_];
+  if (delta_window_ > 0) {
+    blocks[block++] = &deltas_[output_count_ - deltas_first_];
+  }
+  if (accel_window_ > 0) {
+    blocks[block++] = &accels_[output_count_ - accels_first_];
+  }
+  for (int b = 0; b < block; ++b) {
+    const vector<float> &values = *blocks[b];
+    for (int ch = 0; ch < channel_count_; ++ch) {
+      for (int i = 0; i < buffer_length_; ++i) {
+        output_.set_sample(b * channel_count_ + ch, i,
+                           values[ch * buffer_length_ + i]);
+      }
+    }
+  }
+  PushOutput();
+}
+
+void ModuleDeltas::TrimFrames() {
+  // Input frames are needed until they have been normalised and have left
+  // the normalisation window
+  int raw_needed = statics_count_;
+  if (normalize_) {
+    raw_needed = min(raw_needed, window_start_);
+  }
+  while (raw_first_ < raw_needed) {
+    raw_frames_.pop_front();
+    ++raw_first_;
+  }
+
+  // Each set of coefficients is needed until it has been output and has
+  // left the window of the next set
+  int statics_needed = output_count_;
+  if (delta_window_ > 0) {
+    statics_needed = min(statics_needed, deltas_count_ - delta_window_);
+  }
+  while (statics_first_ < statics_needed) {
+    statics_.pop_front();
+    ++statics_first_;
+  }
+
+  // Disabled blocks hold no frames
+  if (delta_window_ > 0) {
+    int deltas_needed = output_count_;
+    if (accel_window_ > 0) {
+      deltas_needed = min(deltas_needed, accels_count_ - accel_window_);
+    }
+    while (deltas_first_ < deltas_needed) {
+      deltas_.pop_front();
+      ++deltas_first_;
+    }
+  }
+
+  if (accel_window_ > 0) {
+    while (accels_first_ < output_count_) {
+      accels_.pop_front();
+      ++accels_first_;
+    }
+  }
+}
+}  // namespace aimc
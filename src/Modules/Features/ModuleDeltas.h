@@ -0,0 +1,145 @@
+// Copyright 2026, agent
+//
+// AIM-C: A C++ implementation of the Auditory Image Model
+// http://www.acousticscale.org/AIMC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*! \file
+ *  \brief Streaming mean and variance normalisation of features, with delta
+ *  and acceleration coefficients
+ */
+
+/*!
+ * \author agent <agent@local>
+ * \date created 2026/10/19
+ * \version \$Id$
+ */
+
+#ifndef AIMC_MODULES_FEATURES_DELTAS_H_
+#define AIMC_MODULES_FEATURES_DELTAS_H_
+
+#include <deque>
+#include <vector>
+
+#include "Support/Module.h"
+
+namespace aimc {
+using std::deque;
+using std::vector;
+class ModuleDeltas : public Module {
+ public:
+  explicit ModuleDeltas(Parameters *pParam);
+  virtual ~ModuleDeltas();
+
+  /*! \brief Process a buffer
+   */
+  virtual void Process(const SignalBank &input);
+
+ private:
+  /*! \brief Reset the internal state of the module. Any frames still waiting
+   *  for lookahead are output first.
+   */
+  virtual void ResetInternal();
+
+  /*! \brief Prepare the module
+   *  \param input Input signal
+   *  \param output true on success false on failure
+   */
+  virtual bool InitializeInternal(const SignalBank &input);
+
+  /*! \brief Compute and output every frame for which enough lookahead is
+   *  available. If finishing is true, the input has ended and the remaining
+   *  frames are completed by repeating the last frame.
+   */
+  void ProcessFrames(bool finishing);
+
+  /*! \brief Mean and variance normalise frame number frame of the input
+   */
+  void NormalizeFrame(int frame, vector<float> *output);
+
+  /*! \brief Regression coefficients, as in HTK, at frame number frame of a
+   *  sequence of frames. Frames beyond either end of the sequence are
+   *  replaced by the first or last frame.
+   *  \param frames The frames held, starting from frame number first
+   *  \param count The total number of frames in the sequence so far
+   */
+  void ComputeDeltas(const deque<vector<float> > &frames, int first,
+                     int count, int frame, int window,
+                     vector<float> *output) const;
+
+  /*! \brief Output frame number output_count_
+   */
+  void OutputFrame();
+
+  /*! \brief Discard frames which are no longer needed
+   */
+  void TrimFrames();
+
+  float sample_rate_;
+  int buffer_length_;
+  int channel_count_;
+  int feature_count_;
+
+  /*! \brief Mean (and optionally variance) normalisation, over a window of
+   *  normalize_half_window_ frames on either side of the current frame. For
+   *  utterance-level normalisation the window is effectively infinite.
+   */
+  bool normalize_;
+  bool normalize_variance_;
+  int normalize_half_window_;
+
+  /*! \brief Delta and acceleration windows, as DELTAWINDOW and ACCWINDOW in
+   *  HTK, or 0 to disable them
+   */
+  int delta_window_;
+  int accel_window_;
+
+  /*! \brief Input frames, and the start time and pitch index of each frame
+   *  not yet output
+   */
+  deque<vector<float> > raw_frames_;
+  int raw_first_;
+  int raw_count_;
+  deque<int> start_times_;
+  deque<int> pitch_indices_;
+
+  /*! \brief Running sums over the normalisation window, which covers input
+   *  frames [window_start_, window_end_)
+   */
+  vector<double> window_sum_;
+  vector<double> window_sum_squares_;
+  int window_start_;
+  int window_end_;
+
+  /*! \brief Normalised static features, deltas and accelerations. Each
+   *  sequence holds frames from number *_first_, and *_count_ frames have
+   *  been computed so far.
+   */
+  deque<vector<float> > statics_;
+  int statics_first_;
+  int statics_count_;
+  deque<vector<float> > deltas_;
+  int deltas_first_;
+  int deltas_count_;
+  deque<vector<float> > accels_;
+  int accels_first_;
+  int accels_count_;
+
+  /*! \brief Number of frames output so far
+   */
+  int output_count_;
+};
+}  // namespace aimc
+
+#endif  // AIMC_MODULES_FEATURES_DELTAS_H_
@@ -0,0 +1,218 @@
+// Copyright 2026, agent
+//
+// AIM-C: A C++ implementation of the Auditory Image Model
+// http://www.acousticscale.org/AIMC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*!
+ * \author agent <agent@local>
+ * \date created 2026/10/19
+ * \version \$Id$
+ */
+
+#include <math.h>
+
+#include <vector>
+
+#include <boost/scoped_ptr.hpp>
+#include <gtest/gtest.h>
+
+#include "Support/Parameters.h"
+#include "Support/SignalBank.h"
+#include "Modules/Features/ModuleDeltas.h"
+
+namespace aimc {
+using boost::scoped_ptr;
+using std::vector;
+
+static const int kChannels = 3;
+static const int kSamples = 2;
+static const int kFrames = 40;
+static const int kFramePeriod = 160;
+static const int kFeatures = kChannels * kSamples;
+
+// Test signals, giving the value of sample i of channel ch of a frame
+static float Wave(int frame, int ch, int i) {
+  return sin(0.3 * frame + ch) + 0.1 * i;
+}
+
+// Rises by RampSlope(ch, i) every frame
+static float RampSlope(int ch, int i) {
+  return 0.5f * (ch + 1) - 0.25f * i;
+}
+
+static float Ramp(int frame, int ch, int i) {
+  return RampSlope(ch, i) * frame + ch;
+}
+
+// Away from zero, and with a large spread, so that normalisation has
+// something to remove
+static float OffsetWave(int frame, int ch, int i) {
+  return 5.0f + 3.0f * sin(0.3 * frame + ch) + i;
+}
+
+// Keeps a copy of every frame it is given, and its start time
+class FrameRecorder : public Module {
+ public:
+  explicit FrameRecorder(Parameters *params) : Module(params) {
+  }
+
+  virtual void Process(const SignalBank &input) {
+    frames_.push_back(vector<float>());
+    for (int ch = 0; ch < input.channel_count(); ++ch) {
+      frames_.back().insert(frames_.back().end(), input[ch].begin(),
+                            input[ch].end());
+    }
+    start_times_.push_back(input.start_time());
+  }
+
+  vector<vector<float> > frames_;
+  vector<int> start_times_;
+
+ private:
+  virtual bool InitializeInternal(const SignalBank &input) {
+    return true;
+  }
+
+  virtual void ResetInternal() {
+  }
+};
+
+class ModuleDeltasTest : public ::testing::Test {
+ protected:
+  void CreateModule(const char *normalize, int normalize_window,
+                    int delta_window, int accel_window) {
+    parameters_.SetString("deltas.normalize", normalize);
+    parameters_.SetInt("deltas.normalize_window", normalize_window);
+    parameters_.SetInt("deltas.delta_window", delta_window);
+    parameters_.SetInt("deltas.accel_window", accel_window);
+    deltas_.reset(new ModuleDeltas(&parameters_));
+    recorder_.reset(new FrameRecorder(&parameters_));
+    deltas_->AddTarget(recorder_.get());
+    input_.Initialize(kChannels, kSamples, 16000.0f);
+    ASSERT_TRUE(deltas_->Initialize(input_, &global_parameters_));
+  }
+
+  // Process frame_count frames of a test signal, starting at the given
+  // time, then end the input
+  void ProcessInput(float (*signal)(int, int, int), int frame_count,
+                    int start_time) {
+    for (int frame = 0; frame < frame_count; ++frame) {
+      for (int ch = 0; ch < kChannels; ++ch) {
+        for (int i = 0; i < kSamples; ++i) {
+          input_.set_sample(ch, i, signal(frame, ch, i));
+        }
+      }
+      input_.set_start_time(start_time + frame * kFramePeriod);
+      deltas_->Process(input_);
+    }
+    deltas_->Reset();
+  }
+
+  Parameters parameters_;
+  Parameters global_parameters_;
+  SignalBank input_;
+  scoped_ptr<ModuleDeltas> deltas_;
+  scoped_ptr<FrameRecorder> recorder_;
+};
+
+TEST_F(ModuleDeltasTest, OutputsEveryFrame) {
+  // Delta window, acceleration window and the number of feature blocks
+  const int kSettings[][3] = { { 0, 0, 1 }, { 2, 0, 2 }, { 2, 2, 3 } };
+  for (int s = 0; s < 3; ++s) {
+    CreateModule("sliding", 10, kSettings[s][0], kSettings[s][1]);
+    ProcessInput(Wave, kFrames, 0);
+    ASSERT_EQ(kFrames, static_cast<int>(recorder_->frames_.size()));
+    for (int frame = 0; frame < kFrames; ++frame) {
+      EXPECT_EQ(kSettings[s][2] * kFeatures,
+                static_cast<int>(recorder_->frames_[frame].size()));
+    }
+  }
+}
+
+TEST_F(ModuleDeltasTest, DeltasOfRampAreItsSlope) {
+  const int kDeltaWindow = 2;
+  const int kAccelWindow = 2;
+  CreateModule("none", 10, kDeltaWindow, kAccelWindow);
+  ProcessInput(Ramp, kFrames, 0);
+  ASSERT_EQ(kFrames, static_cast<int>(recorder_->frames_.size()));
+
+  // Near the ends, the repeated first and last frames bend the ramp
+  for (int frame = kDeltaWindow; frame < kFrames - kDeltaWindow; ++frame) {
+    const vector<float> &features = recorder_->frames_[frame];
+    for (int ch = 0; ch < kChannels; ++ch) {
+      for (int i = 0; i < kSamples; ++i) {
+        int k = ch * kSamples + i;
+        EXPECT_FLOAT_EQ(Ramp(frame, ch, i), features[k]);
+        EXPECT_NEAR(RampSlope(ch, i), features[kFeatures + k], 1e-4);
+      }
+    }
+  }
+  int margin = kDeltaWindow + kAccelWindow;
+  for (int frame = margin; frame < kFrames - margin; ++frame) {
+    const vector<float> &features = recorder_->frames_[frame];
+    for (int k = 0; k < kFeatures; ++k) {
+      EXPECT_NEAR(0.0f, features[2 * kFeatures + k], 1e-4);
+    }
+  }
+}
+
+TEST_F(ModuleDeltasTest, SlidingNormalisationGivesZeroMeanUnitVariance) {
+  const int kLongInput = 400;
+  CreateModule("sliding", 42, 0, 0);
+  ProcessInput(OffsetWave, kLongInput, 0);
+  ASSERT_EQ(kLongInput, static_cast<int>(recorder_->frames_.size()));
+  for (int k = 0; k < kFeatures; ++k) {
+    double sum = 0.0;
+    double sum_squares = 0.0;
+    for (int frame = 0; frame < kLongInput; ++frame) {
+      float value = recorder_->frames_[frame][k];
+      sum += value;
+      sum_squares += value * value;
+    }
+    double mean = sum / kLongInput;
+    EXPECT_NEAR(0.0, mean, 0.05);
+    EXPECT_NEAR(1.0, sum_squares / kLongInput - mean * mean, 0.1);
+  }
+}
+
+TEST_F(ModuleDeltasTest, KeepsStartTimesAcrossLookaheadAndReset) {
+  // The lookahead holds back several frames, and the second input starts
+  // at a different time
+  const int kSecondStart = kFramePeriod / 2;
+  CreateModule("sliding", 10, 2, 2);
+  ProcessInput(Wave, kFrames, 0);
+  ProcessInput(Wave, kFrames, kSecondStart);
+  ASSERT_EQ(2 * kFrames, static_cast<int>(recorder_->start_times_.size()));
+  for (int frame = 0; frame < kFrames; ++frame) {
+    EXPECT_EQ(frame * kFramePeriod, recorder_->start_times_[frame]);
+    EXPECT_EQ(kSecondStart + frame * kFramePeriod,
+              recorder_->start_times_[kFrames + frame]);
+  }
+}
+
+TEST_F(ModuleDeltasTest, ResetGivesIdenticalOutput) {
+  CreateModule("sliding", 10, 2, 2);
+  ProcessInput(Wave, kFrames, 0);
+  ProcessInput(Wave, kFrames, 0);
+  ASSERT_EQ(2 * kFrames, static_cast<int>(recorder_->frames_.size()));
+  for (int frame = 0; frame < kFrames; ++frame) {
+    const vector<float> &first = recorder_->frames_[frame];
+    const vector<float> &second = recorder_->frames_[kFrames + frame];
+    for (unsigned int k = 0; k < first.size(); ++k) {
+      EXPECT_FLOAT_EQ(first[k], second[k]);
+    }
+  }
+}
+}  // namespace aimc
@@ -53,15 +53,27 @@ ModuleGaussians::ModuleGaussians(Parameters *params) : Module(params) {
   parameters_->DefaultString("gaussians.priors_converged", "1e-7");
   priors_converged_ = parameters_->GetFloat("gaussians.priors_converged");
   output_positions_ = parameters_->DefaultBool("gaussians.positions", false);
+
+  // Seed each fit from the previous frame's converged priors and means,
+  // rather than from uniformly spaced components. The fit is started from
+  // scratch again if the log energy changes by more than
+  // warm_start_energy_jump between frames.
+  warm_start_ = parameters_->DefaultBool("gaussians.warm_start", false);
+  warm_start_energy_jump_ = parameters_->DefaultFloat(
+      "gaussians.warm_start_energy_jump", 1.0f);
+  report_iterations_ = parameters_->DefaultBool("gaussians.report_iterations",
+                                                false);
+
+  // Number of frames collected before they are fitted together. Unless
+  // warm_start is set, the frames in a batch are fitted in parallel. The
+  // outputs are emitted in order once the whole batch has been fitted.
+  batch_size_ = parameters_->DefaultInt("gaussians.batch_size", 1);
 }
 
 ModuleGaussians::~ModuleGaussians() {
 }
 
 bool ModuleGaussians::InitializeInternal(const SignalBank &input) {
-  m_pA.resize(m_iParamNComp, 0.0f);
-  m_pMu.resize(m_iParamNComp, 0.0f);
-
   // Assuming the number of channels is greater than twice the number of
   // Gaussian components, this is ok
   output_component_count_ = 1; // Energy component
@@ -78,21 +90,81 @@ bool ModuleGaussians::InitializeInternal(const SignalBank &input) {
     output_component_count_ += m_iParamNComp;
   }
 
+  if (batch_size_ < 1) {
+    LOG_ERROR(_T("gaussians.batch_size must be at least 1"));
+    return false;
+  }
+
   output_.Initialize(output_component_count_, 1, input.sample_rate());
 
   m_iNumChannels = input.channel_count();
-  m_pSpectralProfile.resize(m_iNumChannels, 0.0f);
+
+  // State and working space for the fit to each frame in a batch
+  fits_.resize(batch_size_);
+  for (int f = 0; f < batch_size_; ++f) {
+    GaussianFit &fit = fits_[f];
+    fit.pSpectralProfile.resize(m_iNumChannels, 0.0f);
+    fit.pA.resize(m_iParamNComp, 0.0f);
+    fit.pMu.resize(m_iParamNComp, 0.0f);
+    fit.pA_old.resize(m_iParamNComp);
+    fit.pP_mod_X.resize(m_iNumChannels);
+    fit.pP_comp.resize(m_iNumChannels * m_iParamNComp);
+  }
+  pending_frame_count_ = 0;
+  previous_a_.resize(m_iParamNComp, 0.0f);
+  previous_mu_.resize(m_iParamNComp, 0.0f);
+
+  // The observations are at channel positions 1, 2, ..., m_iNumChannels
+  m_pChannelPosition.resize(m_iNumChannels);
+  for (int i = 0; i < m_iNumChannels; ++i) {
+    m_pChannelPosition[i] = static_cast<float>(i + 1);
+  }
+
+  // exp(-j^2 / 2var) for each integer distance j between channels
+  m_pGaussianTable.resize(m_iNumChannels);
+  for (int j = 0; j < m_iNumChannels; ++j) {
+    m_pGaussianTable[j] = exp(-0.5 * j * j / m_fParamVar);
+  }
+
+  // Small positive integer values of the posterior expansion exponent are
+  // handled by repeated multiplication rather than by pow()
+  m_iPosteriorExpInt = 0;
+  if (m_fParamPosteriorExp >= 1.0f && m_fParamPosteriorExp <= 16.0f
+      && floor(m_fParamPosteriorExp) == m_fParamPosteriorExp) {
+    m_iPosteriorExpInt = static_cast<int>(m_fParamPosteriorExp);
+  }
+
+  frame_count_ = 0;
+  warm_start_count_ = 0;
+  iteration_count_ = 0;
+  previous_fit_valid_ = false;
+  previous_log_energy_ = 0.0f;
 
   return true;
 }
 
 void ModuleGaussians::ResetInternal() {
-  m_pSpectralProfile.clear();
-  m_pSpectralProfile.resize(m_iNumChannels, 0.0f);
-  m_pA.clear();
-  m_pA.resize(m_iParamNComp, 0.0f);
-  m_pMu.clear();
-  m_pMu.resize(m_iParamNComp, 0.0f);
+  // Frames still waiting in a partial batch belong to the signal that has
+  // just finished, so they are output before anything else is reset
+  FitPendingFrames();
+
+  if (report_iterations_ && frame_count_ > 0) {
+    LOG_INFO(_T("Gaussians: %d frames (%d warm-started), %d EM iterations, "
+                "%f per frame"), frame_count_, warm_start_count_,
+             iteration_count_,
+             static_cast<float>(iteration_count_) / frame_count_);
+  }
+  frame_count_ = 0;
+  warm_start_count_ = 0;
+  iteration_count_ = 0;
+  previous_fit_valid_ = false;
+  previous_log_energy_ = 0.0f;
+  for (int f = 0; f < batch_size_; ++f) {
+    GaussianFit &fit = fits_[f];
+    fit.pSpectralProfile.assign(m_iNumChannels, 0.0f);
+    fit.pA.assign(m_iParamNComp, 0.0f);
+    fit.pMu.assign(m_iParamNComp, 0.0f);
+  }
 }
 
 void ModuleGaussians::Process(const SignalBank &input) {
@@ -100,44 +172,103 @@ void ModuleGaussians::Process(const SignalBank &input) {
     LOG_ERROR(_T("Module ModuleGaussians not initialized."));
     return;
   }
-  output_.set_start_time(input.start_time());
+  GaussianFit &fit = fits_[pending_frame_count_];
+  fit.start_time = input.start_time();
+  fit.pitch_index = input.pitch_index();
+  vector<float> &pSpectralProfile = fit.pSpectralProfile;
+
   // Calculate spectral profile
   for (int ch = 0; ch < input.channel_count(); ++ch) {
-    m_pSpectralProfile[ch] = 0.0f;
+    pSpectralProfile[ch] = 0.0f;
     for (int i = 0; i < input.buffer_length(); ++i) {
-      m_pSpectralProfile[ch] += input[ch][i];
+      pSpectralProfile[ch] += input[ch][i];
     }
-    m_pSpectralProfile[ch] /= static_cast<float>(input.buffer_length());
+    pSpectralProfile[ch] /= static_cast<float>(input.buffer_length());
   }
 
   float spectral_profile_sum = 0.0f;
   for (int i = 0; i < input.channel_count(); ++i) {
-    spectral_profile_sum += m_pSpectralProfile[i];
+    spectral_profile_sum += pSpectralProfile[i];
   }
+  fit.log_energy = log(spectral_profile_sum);
 
-  // Set the last component of the feature vector to be the log energy
-  float logsum = log(spectral_profile_sum);
-  if (!isinf(logsum)) {
-    output_.set_sample(output_component_count_ - 1, 0, logsum);
+  for (int ch = 0; ch < input.channel_count(); ++ch) {
+    pSpectralProfile[ch] = pow(pSpectralProfile[ch], 0.8f);
+  }
+
+  ++pending_frame_count_;
+  if (pending_frame_count_ == batch_size_) {
+    FitPendingFrames();
+  }
+}
+
+void ModuleGaussians::FitPendingFrames() {
+  if (warm_start_) {
+    // Each fit may be seeded from the one before, so the frames are fitted
+    // in order
+    for (int f = 0; f < pending_frame_count_; ++f) {
+      GaussianFit &fit = fits_[f];
+      // The previous frame's fit is only used as a starting point if the
+      // energy has not jumped since then
+      bool warm_start = previous_fit_valid_
+                        && !isinf(fit.log_energy)
+                        && fabs(fit.log_energy - previous_log_energy_)
+                           <= warm_start_energy_jump_;
+      if (warm_start) {
+        fit.pA = previous_a_;
+        fit.pMu = previous_mu_;
+        ++warm_start_count_;
+      }
+      FitFrame(&fit, warm_start);
+
+      // A fit can seed the next frame if all its components are still alive
+      previous_log_energy_ = fit.log_energy;
+      previous_fit_valid_ = !isinf(fit.log_energy);
+      for (int i = 0; i < m_iParamNComp; ++i) {
+        if (!(fit.pA[i] > 0.0f) || isnan(fit.pMu[i])) {
+          previous_fit_valid_ = false;
+        }
+      }
+      previous_a_ = fit.pA;
+      previous_mu_ = fit.pMu;
+    }
   } else {
-    output_.set_sample(output_component_count_ - 1, 0, -1000.0);
+    // Frames are independent, and can be fitted in parallel
+    #pragma omp parallel for schedule(dynamic)
+    for (int f = 0; f < pending_frame_count_; ++f) {
+      FitFrame(&fits_[f], false);
+    }
   }
 
-  for (int ch = 0; ch < input.channel_count(); ++ch) {
-    m_pSpectralProfile[ch] = pow(m_pSpectralProfile[ch], 0.8f);
+  for (int f = 0; f < pending_frame_count_; ++f) {
+    ++frame_count_;
+    iteration_count_ += fits_[f].iteration_count;
+    OutputFit(fits_[f]);
+  }
+  pending_frame_count_ = 0;
+}
+
+void ModuleGaussians::FitFrame(GaussianFit *fit, bool warm_start) const {
+  vector<float> &pA = fit->pA;
+  vector<float> &pMu = fit->pMu;
+  fit->iteration_count = 0;
+
+  if (warm_start) {
+    RubberGMMCore(fit, m_iParamNComp, false);
+    return;
   }
 
-  RubberGMMCore(2, true);
+  RubberGMMCore(fit, 2, true);
 
-  float mean1 = m_pMu[0];
-  float mean2 = m_pMu[1];
-  // LOG_INFO(_T("Orig. mean 0 = %f"), m_pMu[0]);
-  // LOG_INFO(_T("Orig. mean 1 = %f"), m_pMu[1]);
-  // LOG_INFO(_T("Orig. prob 0 = %f"), m_pA[0]);
-  // LOG_INFO(_T("Orig. prob 1 = %f"), m_pA[1]);
+  float mean1 = pMu[0];
+  float mean2 = pMu[1];
+  // LOG_INFO(_T("Orig. mean 0 = %f"), pMu[0]);
+  // LOG_INFO(_T("Orig. mean 1 = %f"), pMu[1]);
+  // LOG_INFO(_T("Orig. prob 0 = %f"), pA[0]);
+  // LOG_INFO(_T("Orig. prob 1 = %f"), pA[1]);
 
-  float a1 = 0.05 * m_pA[0];
-  float a2 = 1.0 - 0.25 * m_pA[1];
+  float a1 = 0.05 * pA[0];
+  float a2 = 1.0 - 0.25 * pA[1];
 
   // LOG_INFO(_T("fA1 = %f"), fA1);
   // LOG_INFO(_T("fA2 = %f"), fA2);
@@ -149,22 +280,36 @@ void ModuleGaussians::Process(const SignalBank &input) {
   // LOG_INFO(_T("fIntercept = %f"), fIntercept);
 
   for (int i = 0; i < m_iParamNComp; ++i) {
-    m_pMu[i] = (static_cast<float>(i)
-                / (static_cast<float>(m_iParamNComp) - 1.0f))
-                * gradient + intercept;
-                // LOG_INFO(_T("mean %d = %f"), i, m_pMu[i]);
+    pMu[i] = (static_cast<float>(i)
+              / (static_cast<float>(m_iParamNComp) - 1.0f))
+              * gradient + intercept;
+              // LOG_INFO(_T("mean %d = %f"), i, pMu[i]);
   }
 
   for (int i = 0; i < m_iParamNComp; ++i) {
-    m_pA[i] = 1.0f / static_cast<float>(m_iParamNComp);
+    pA[i] = 1.0f / static_cast<float>(m_iParamNComp);
   }
 
-  RubberGMMCore(m_iParamNComp, false);
+  RubberGMMCore(fit, m_iParamNComp, false);
+}
+
+void ModuleGaussians::OutputFit(const GaussianFit &fit) {
+  const vector<float> &pA = fit.pA;
+  const vector<float> &pMu = fit.pMu;
+  output_.set_start_time(fit.start_time);
+  output_.set_pitch_index(fit.pitch_index);
+
+  // Set the last component of the feature vector to be the log energy
+  if (!isinf(fit.log_energy)) {
+    output_.set_sample(output_component_count_ - 1, 0, fit.log_energy);
+  } else {
+    output_.set_sample(output_component_count_ - 1, 0, -1000.0);
+  }
 
   // Amplitudes first
   for (int i = 0; i < m_iParamNComp - 1; ++i) {
-    if (!isnan(m_pA[i])) {
-      output_.set_sample(i, 0, m_pA[i]);
+    if (!isnan(pA[i])) {
+      output_.set_sample(i, 0, pA[i]);
     } else {
       output_.set_sample(i, 0, 0.0f);
     }
@@ -174,8 +319,8 @@ void ModuleGaussians::Process(const SignalBank &input) {
   if (output_positions_) {
     int idx = 0;
     for (int i = m_iParamNComp - 1; i < 2 * m_iParamNComp - 1; ++i) {
-      if (!isnan(m_pMu[i])) {
-        output_.set_sample(i, 0, m_pMu[idx]);
+      if (!isnan(pMu[i])) {
+        output_.set_sample(i, 0, pMu[idx]);
       } else {
         output_.set_sample(i, 0, 0.0f);
       }
@@ -186,89 +331,141 @@ void ModuleGaussians::Process(const SignalBank &input) {
   PushOutput();
 }
 
-bool ModuleGaussians::RubberGMMCore(int iNComponents, bool bDoInit) {
+float ModuleGaussians::PosteriorExpansion(float fP) const {
+  // The default exponent of 6 is computed by repeated squaring
+  if (m_iPosteriorExpInt == 6) {
+    float fP2 = fP * fP;
+    return fP2 * fP2 * fP2;
+  }
+  if (m_iPosteriorExpInt > 0) {
+    float fResult = fP;
+    for (int i = 1; i < m_iPosteriorExpInt; ++i)
+      fResult *= fP;
+    return fResult;
+  }
+  return pow(fP, m_fParamPosteriorExp);
+}
+
+bool ModuleGaussians::RubberGMMCore(GaussianFit *fit, int iNComponents,
+                                    bool bDoInit) const {
   int iSizeX = m_iNumChannels;
+  vector<float> &pSpectralProfile = fit->pSpectralProfile;
+  vector<float> &pA = fit->pA;
+  vector<float> &pMu = fit->pMu;
+  vector<float> &pA_old = fit->pA_old;
+  vector<float> &pP_mod_X = fit->pP_mod_X;
+  vector<float> &pP_comp = fit->pP_comp;
 
   // Normalise the spectral profile
   float SpectralProfileTotal = 0.0f;
   for (int iCount = 0; iCount < iSizeX; iCount++) {
-    SpectralProfileTotal += m_pSpectralProfile[iCount];
+    SpectralProfileTotal += pSpectralProfile[iCount];
   }
   for (int iCount = 0; iCount < iSizeX; iCount++) {
-    m_pSpectralProfile[iCount] /= SpectralProfileTotal;
+    pSpectralProfile[iCount] /= SpectralProfileTotal;
   }
 
   if (bDoInit) {
     // Uniformly spaced components
     float dd = (iSizeX - 1.0f) / iNComponents;
     for (int i = 0; i < iNComponents; i++) {
-      m_pMu[i] = dd / 2.0f + (i * dd);
-      m_pA[i] = 1.0f / iNComponents;
+      pMu[i] = dd / 2.0f + (i * dd);
+      pA[i] = 1.0f / iNComponents;
     }
   }
 
-  vector<float> pA_old;
-  pA_old.resize(iNComponents);
-  vector<float> pP_mod_X;
-  pP_mod_X.resize(iSizeX);
-  vector<float> pP_comp;
-  pP_comp.resize(iSizeX * iNComponents);
+  // The Gaussian normalisation factor depends only on the (fixed) variance
+  double dNorm = 1.0 / sqrt(2.0 * M_PI * m_fParamVar);
 
   for (int iIteration = 0; iIteration < m_iParamMaxIt; iIteration++) {
+    ++fit->iteration_count;
+    // Evaluate each weighted component density once at every observation
+    // point X. The variance is fixed and the observations lie on an integer
+    // grid, so with k0 the point nearest to the mean and f = k0 - mu,
+    //   exp(-(k0 + j - mu)^2 / 2var)
+    //     = exp(-j^2 / 2var) * exp(-j f / var) * exp(-f^2 / 2var)
+    // where the first factor is tabulated and the second is a running
+    // product. Working outwards from k0 the density only decreases.
+    for (int i = 0; i < iNComponents; ++i) {
+      float *pComp = &pP_comp[i * iSizeX];
+      float fNearest = floor(pMu[i] + 0.5f);
+      int iNearest;
+      if (!(fNearest >= 1.0f)) {
+        iNearest = 0;
+      } else if (fNearest > iSizeX) {
+        iNearest = iSizeX - 1;
+      } else {
+        iNearest = static_cast<int>(fNearest) - 1;
+      }
+      double dOffset = m_pChannelPosition[iNearest] - pMu[i];
+      double dBase = dNorm * pA[i]
+                     * exp(-0.5 * dOffset * dOffset / m_fParamVar);
+      pComp[iNearest] = dBase;
+      double dStep = exp(-dOffset / m_fParamVar);
+      double dProduct = dBase;
+      for (int j = 1; iNearest + j < iSizeX; ++j) {
+        dProduct *= dStep;
+        pComp[iNearest + j] = dProduct * m_pGaussianTable[j];
+      }
+      dStep = exp(dOffset / m_fParamVar);
+      dProduct = dBase;
+      for (int j = 1; iNearest - j >= 0; ++j) {
+        dProduct *= dStep;
+        pComp[iNearest - j] = dProduct * m_pGaussianTable[j];
+      }
+    }
+
     // (re)calculate posteriors (component probability given observation)
     // denominator: the model density at all observation points X
-    for (int i = 0; i < iSizeX; ++i) {
-      pP_mod_X[i] = 0.0f;
+    for (int iCount = 0; iCount < iSizeX; ++iCount) {
+      pP_mod_X[iCount] = 0.0f;
     }
-
-    for (int c = 0; c < iNComponents; c++) {
-      for (int iCount = 0; iCount < iSizeX; iCount++) {
-        pP_mod_X[iCount] += 1.0f / sqrt(2.0f * M_PI * m_fParamVar)
-                            * exp((-0.5f)
-                            * pow(static_cast<float>(iCount+1) - m_pMu[c], 2)
-                            / m_fParamVar) * m_pA[c];
+    for (int i = 0; i < iNComponents; ++i) {
+      const float *pComp = &pP_comp[i * iSizeX];
+      for (int iCount = 0; iCount < iSizeX; ++iCount) {
+        pP_mod_X[iCount] += pComp[iCount];
       }
     }
 
-    for (int i = 0; i < iSizeX * iNComponents; ++i) {
-      pP_comp[i] = 0.0f;
-    }
-
-    for (int i = 0; i < iNComponents; i++) {
-      for (int iCount = 0; iCount < iSizeX; iCount++) {
-        pP_comp[iCount + i * iSizeX] =
-          1.0f / sqrt(2.0f * M_PI * m_fParamVar)
-          * exp((-0.5f) * pow((static_cast<float>(iCount + 1) - m_pMu[i]), 2)
-          / m_fParamVar);
-        pP_comp[iCount + i * iSizeX] =
-          pP_comp[iCount + i * iSizeX] * m_pA[i] / pP_mod_X[iCount];
+    // Posterior, and expansion
+    for (int i = 0; i < iNComponents; ++i) {
+      float *pComp = &pP_comp[i * iSizeX];
+      for (int iCount = 0; iCount < iSizeX; ++iCount) {
+        pComp[iCount] = PosteriorExpansion(pComp[iCount]
+                                           / pP_mod_X[iCount]);
       }
     }
 
+    // Renormalisation
     for (int iCount = 0; iCount < iSizeX; ++iCount) {
-      float fSum = 0.0f;
-      for (int i = 0; i < iNComponents; ++i) {
-        pP_comp[iCount+i*iSizeX] = pow(pP_comp[iCount + i * iSizeX],
-                                       m_fParamPosteriorExp);  // expansion
-        fSum += pP_comp[iCount+i*iSizeX];
+      pP_mod_X[iCount] = 0.0f;
+    }
+    for (int i = 0; i < iNComponents; ++i) {
+      const float *pComp = &pP_comp[i * iSizeX];
+      for (int iCount = 0; iCount < iSizeX; ++iCount) {
+        pP_mod_X[iCount] += pComp[iCount];
+      }
+    }
+    for (int i = 0; i < iNComponents; ++i) {
+      float *pComp = &pP_comp[i * iSizeX];
+      for (int iCount = 0; iCount < iSizeX; ++iCount) {
+        pComp[iCount] /= pP_mod_X[iCount];
       }
-      for (int i = 0; i < iNComponents; ++i)
-        pP_comp[iCount+i*iSizeX] = pP_comp[iCount + i * iSizeX] / fSum;
-        // renormalisation
     }
 
     for (int i = 0; i < iNComponents; ++i) {
-      pA_old[i] = m_pA[i];
-      m_pA[i] = 0.0f;
+      pA_old[i] = pA[i];
+      pA[i] = 0.0f;
       for (int iCount = 0; iCount < iSizeX; ++iCount) {
-        m_pA[i] += pP_comp[iCount + i * iSizeX] * m_pSpectralProfile[iCount];
+        pA[i] += pP_comp[iCount + i * iSizeX] * pSpectralProfile[iCount];
       }
     }
 
     // finish when already converged
     float fPrdist = 0.0f;
     for (int i = 0; i < iNComponents; ++i) {
-      fPrdist += pow((m_pA[i] - pA_old[i]), 2);
+      float fDiff = pA[i] - pA_old[i];
+      fPrdist += fDiff * fDiff;
     }
     fPrdist /= iNComponents;
 
@@ -281,17 +478,17 @@ bool ModuleGaussians::RubberGMMCore(int iNComponents, bool bDoInit) {
 
     // update means (positions)
     for (int i = 0 ; i < iNComponents; ++i) {
-      float mu_old = m_pMu[i];
-      if (m_pA[i] > 0.0f) {
-        m_pMu[i] = 0.0f;
+      float mu_old = pMu[i];
+      if (pA[i] > 0.0f) {
+        pMu[i] = 0.0f;
         for (int iCount = 0; iCount < iSizeX; ++iCount) {
-          m_pMu[i] += m_pSpectralProfile[iCount]
+          pMu[i] += pSpectralProfile[iCount]
                       * pP_comp[iCount + i * iSizeX]
-                      * static_cast<float>(iCount + 1);
+                      * m_pChannelPosition[iCount];
         }
-        m_pMu[i] /= m_pA[i];
-        if (isnan(m_pMu[i])) {
-          m_pMu[i] = mu_old;
+        pMu[i] /= pA[i];
+        if (isnan(pMu[i])) {
+          pMu[i] = mu_old;
         }
       }
     }
@@ -302,13 +499,13 @@ bool ModuleGaussians::RubberGMMCore(int iNComponents, bool bDoInit) {
   while (!bSorted) {
     bSorted = true;
     for (int i = 0; i < iNComponents - 1; ++i) {
-      if (m_pMu[i] > m_pMu[i + 1]) {
-        float fTemp = m_pMu[i];
-        m_pMu[i] = m_pMu[i + 1];
-        m_pMu[i + 1] = fTemp;
-        fTemp = m_pA[i];
-        m_pA[i] = m_pA[i + 1];
-        m_pA[i + 1] = fTemp;
+      if (pMu[i] > pMu[i + 1]) {
+        float fTemp = pMu[i];
+        pMu[i] = pMu[i + 1];
+        pMu[i + 1] = fTemp;
+        fTemp = pA[i];
+        pA[i] = pA[i + 1];
+        pA[i + 1] = fTemp;
         bSorted = false;
       }
     }
@@ -44,6 +44,19 @@ class ModuleGaussians : public Module {
    */
   virtual void Process(const SignalBank &input);
 
+  /*! \brief Number of frames fitted since the last reset
+   */
+  int frame_count() const { return frame_count_; }
+
+  /*! \brief Number of those frames which were warm-started from the
+   *  previous frame's fit
+   */
+  int warm_start_count() const { return warm_start_count_; }
+
+  /*! \brief Total number of EM iterations used since the last reset
+   */
+  int iteration_count() const { return iteration_count_; }
+
  private:
   /*! \brief Reset the internal state of the module
    */
@@ -55,7 +68,52 @@ class ModuleGaussians : public Module {
    */
   virtual bool InitializeInternal(const SignalBank &input);
 
-  bool RubberGMMCore(int iNumComponents, bool bDoInit);
+  /*! \brief State of the fit to a single frame
+   */
+  struct GaussianFit {
+    /*! \brief The spectral profile of the frame
+     */
+    vector<float> pSpectralProfile;
+
+    /*! \brief The amplitudes (priors) and means of the components
+     */
+    vector<float> pA;
+    vector<float> pMu;
+
+    /*! \brief Working space for the EM iterations: previous priors, model
+     *  density at each channel, and the component posteriors for each
+     *  channel
+     */
+    vector<float> pA_old;
+    vector<float> pP_mod_X;
+    vector<float> pP_comp;
+
+    float log_energy;
+    int start_time;
+    int pitch_index;
+    int iteration_count;
+  };
+
+  /*! \brief Fit all the frames collected so far, and output the results in
+   *  order
+   */
+  void FitPendingFrames();
+
+  /*! \brief Fit the Gaussian mixture to a single frame, either from scratch
+   *  or, if warm_start is true, from the priors and means already in fit
+   */
+  void FitFrame(GaussianFit *fit, bool warm_start) const;
+
+  /*! \brief Output the features for a fitted frame
+   */
+  void OutputFit(const GaussianFit &fit);
+
+  bool RubberGMMCore(GaussianFit *fit, int iNumComponents,
+                     bool bDoInit) const;
+
+  /*! \brief Raise a posterior probability to the power m_fParamPosteriorExp
+   */
+  float PosteriorExpansion(float fP) const;
 
   /*! \brief Number of Gaussian Components
    */
@@ -69,6 +127,11 @@ class ModuleGaussians : public Module {
    */
   float m_fParamPosteriorExp;
 
+  /*! \brief Posterior expansion exponent, if it is a small positive
+   *  integer, or zero otherwise
+   */
+  int m_iPosteriorExpInt;
+
   /*! \brief Maximum Number of iterations
    */
   int m_iParamMaxIt;
@@ -85,19 +148,52 @@ class ModuleGaussians : public Module {
    */
   int output_component_count_;
 
-  /*! \brief The amplitudes of the components (priors)
+  /*! \brief Position of each channel, as used for the Gaussian fit
+   */
+  vector<float> m_pChannelPosition;
+
+  /*! \brief Unnormalised Gaussian with the fixed variance, evaluated at
+   *  each integer distance between channels
    */
-  vector<float> m_pA;
+  vector<double> m_pGaussianTable;
 
-  /*! \brief The means of the components (priors)
+  /*! \brief Frames waiting to be fitted. Only the first
+   *  pending_frame_count_ entries are in use.
    */
-  vector<float> m_pMu;
+  vector<GaussianFit> fits_;
+  int pending_frame_count_;
 
-  /*! \brief The spectral profile of the incoming buffer
+  /*! \brief Number of frames fitted together
    */
-  vector<float> m_pSpectralProfile;
+  int batch_size_;
 
   int m_iNumChannels;
+
+  /*! \brief Seed each fit from the previous frame's fit
+   */
+  bool warm_start_;
+
+  /*! \brief Largest change in log energy between frames for which the
+   *  previous fit is used as a starting point
+   */
+  float warm_start_energy_jump_;
+
+  /*! \brief Log the iteration statistics when the module is reset
+   */
+  bool report_iterations_;
+
+  /*! \brief The most recent fit, and whether it can seed the next one
+   */
+  vector<float> previous_a_;
+  vector<float> previous_mu_;
+  bool previous_fit_valid_;
+  float previous_log_energy_;
+
+  /*! \brief Iteration statistics
+   */
+  int frame_count_;
+  int warm_start_count_;
+  int iteration_count_;
 };
 }  // namespace aimc
 
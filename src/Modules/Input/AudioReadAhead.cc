@@ -0,0 +1,230 @@
+// Copyright 2026, agent
+//
+// AIM-C: A C++ implementation of the Auditory Image Model
+// http://www.acousticscale.org/AIMC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*! \author agent <agent@local>
+ *  \date 2026/10/19
+ *  \version \$Id$
+ */
+
+#include <string.h>
+
+#include <sndfile.h>
+
+#include "Modules/Input/AudioReadAhead.h"
+
+namespace aimc {
+AudioReadAhead::AudioReadAhead(int buffer_length, int block_count)
+    : buffer_length_(buffer_length),
+      stopping_(false),
+      last_job_(0),
+      current_job_(0),
+      current_job_finished_(true),
+      prefetch_job_(0),
+      opened_job_(0),
+      opened_ok_(false),
+      opened_channels_(0),
+      opened_sample_rate_(0.0f) {
+  if (block_count < 1) {
+    block_count = 1;
+  }
+  blocks_.resize(block_count);
+  for (int i = 0; i < block_count; ++i) {
+    free_blocks_.push_back(&blocks_[i]);
+  }
+}
+
+AudioReadAhead::~AudioReadAhead() {
+  Stop();
+}
+
+void AudioReadAhead::Stop() {
+  {
+    MutexLock lock(&mutex_);
+    stopping_ = true;
+    condition_.Broadcast();
+  }
+  Join();
+}
+
+bool AudioReadAhead::OpenFile(const string &filename, int *channels,
+                              float *sample_rate) {
+  if (!running() && !Start()) {
+    LOG_ERROR(_T("Couldn't start the audio read-ahead thread"));
+    return false;
+  }
+
+  MutexLock lock(&mutex_);
+  if (prefetch_job_ != 0 && prefetch_filename_ == filename) {
+    current_job_ = prefetch_job_;
+  } else {
+    // Anything decoded or queued so far is no longer wanted
+    jobs_.clear();
+    current_job_ = ++last_job_;
+    Job job;
+    job.id = current_job_;
+    job.filename = filename;
+    jobs_.push_back(job);
+  }
+  prefetch_job_ = 0;
+  current_job_finished_ = false;
+  condition_.Broadcast();
+
+  while (opened_job_ < current_job_ && !stopping_) {
+    condition_.Wait(&mutex_);
+  }
+  if (opened_job_ != current_job_ || !opened_ok_) {
+    current_job_finished_ = true;
+    return false;
+  }
+  *channels = opened_channels_;
+  *sample_rate = opened_sample_rate_;
+  return true;
+}
+
+void AudioReadAhead::Prefetch(const string &filename) {
+  MutexLock lock(&mutex_);
+  prefetch_job_ = ++last_job_;
+  prefetch_filename_ = filename;
+  Job job;
+  job.id = prefetch_job_;
+  job.filename = filename;
+  jobs_.push_back(job);
+  condition_.Broadcast();
+}
+
+AudioReadAhead::Block *AudioReadAhead::NextBlock() {
+  MutexLock lock(&mutex_);
+  if (current_job_finished_) {
+    return NULL;
+  }
+  Block *block = WaitForBlock();
+  if (block == NULL || block->frame_count < buffer_length_) {
+    current_job_finished_ = true;
+  }
+  return block;
+}
+
+void AudioReadAhead::RecycleBlock(Block *block) {
+  MutexLock lock(&mutex_);
+  free_blocks_.push_back(block);
+  condition_.Broadcast();
+}
+
+AudioReadAhead::Block *AudioReadAhead::WaitForBlock() {
+  while (!stopping_) {
+    while (!ready_blocks_.empty() && ready_blocks_.front()->job
+                                     < current_job_) {
+      free_blocks_.push_back(ready_blocks_.front());
+      ready_blocks_.pop_front();
+      condition_.Broadcast();
+    }
+    if (!ready_blocks_.empty()) {
+      Block *block = ready_blocks_.front();
+      ready_blocks_.pop_front();
+      return block;
+    }
+    condition_.Wait(&mutex_);
+  }
+  return NULL;
+}
+
+AudioReadAhead::Block *AudioReadAhead::AcquireBlock(int job) {
+  while (!stopping_ && job >= current_job_ && free_blocks_.empty()) {
+    condition_.Wait(&mutex_);
+  }
+  if (stopping_ || job < current_job_) {
+    return NULL;
+  }
+  Block *block = free_blocks_.back();
+  free_blocks_.pop_back();
+  block->job = job;
+  return block;
+}
+
+void AudioReadAhead::PublishBlock(Block *block) {
+  ready_blocks_.push_back(block);
+  condition_.Broadcast();
+}
+
+void AudioReadAhead::Run() {
+  vector<float> interleaved;
+  while (true) {
+    Job job;
+    {
+      MutexLock lock(&mutex_);
+      while (!stopping_ && jobs_.empty()) {
+        condition_.Wait(&mutex_);
+      }
+      if (stopping_) {
+        return;
+      }
+      job = jobs_.front();
+      jobs_.pop_front();
+    }
+
+    SF_INFO sfinfo;
+    memset(reinterpret_cast<void*>(&sfinfo), 0, sizeof(SF_INFO));
+    SNDFILE *file_handle = sf_open(job.filename.c_str(), SFM_READ, &sfinfo);
+    {
+      MutexLock lock(&mutex_);
+      opened_job_ = job.id;
+      opened_ok_ = (file_handle != NULL);
+      opened_channels_ = sfinfo.channels;
+      opened_sample_rate_ = sfinfo.samplerate;
+      condition_.Broadcast();
+    }
+    if (file_handle == NULL) {
+      continue;
+    }
+
+    int channels = sfinfo.channels;
+    interleaved.resize(buffer_length_ * channels);
+    while (true) {
+      Block *block;
+      {
+        MutexLock lock(&mutex_);
+        block = AcquireBlock(job.id);
+      }
+      if (block == NULL) {
+        break;
+      }
+
+      // Decode and de-interleave without holding the lock
+      sf_count_t read = sf_readf_float(file_handle, &interleaved[0],
+                                       buffer_length_);
+      block->frame_count = read;
+      block->samples.resize(buffer_length_ * channels);
+      for (int c = 0; c < channels; ++c) {
+        float *samples = &block->samples[c * buffer_length_];
+        const float *source = &interleaved[c];
+        for (int i = 0; i < read; ++i) {
+          samples[i] = source[i * channels];
+        }
+      }
+
+      {
+        MutexLock lock(&mutex_);
+        PublishBlock(block);
+      }
+      if (read < buffer_length_) {
+        break;
+      }
+    }
+    sf_close(file_handle);
+  }
+}
+}  // namespace aimc
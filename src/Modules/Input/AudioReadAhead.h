@@ -0,0 +1,140 @@
+// Copyright 2026, agent
+//
+// AIM-C: A C++ implementation of the Auditory Image Model
+// http://www.acousticscale.org/AIMC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*! \file
+ *  \brief Background decoding of audio files into a pool of buffers
+ */
+
+/*! \author agent <agent@local>
+ *  \date 2026/10/19
+ *  \version \$Id$
+ */
+
+#ifndef AIMC_MODULES_INPUT_AUDIOREADAHEAD_H_
+#define AIMC_MODULES_INPUT_AUDIOREADAHEAD_H_
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "Support/Thread.h"
+
+namespace aimc {
+using std::deque;
+using std::string;
+using std::vector;
+
+/*! \brief Decodes audio files with libsndfile on a background thread.
+ *
+ * The file is read in blocks of a fixed number of frames, which are
+ * de-interleaved into a fixed pool of buffers while the caller processes
+ * earlier blocks. Once a file has been read to the end, the reader can go
+ * on to decode the start of the next file, so that opening it later costs
+ * nothing.
+ */
+class AudioReadAhead : public Thread {
+ public:
+  /*! \brief A block of audio, de-interleaved so that the samples of channel
+   *  c are at samples[c * buffer_length]
+   */
+  struct Block {
+    int job;
+    int frame_count;
+    vector<float> samples;
+  };
+
+  /*! \param buffer_length Number of frames in each block
+   *  \param block_count Number of blocks which may be decoded ahead
+   */
+  AudioReadAhead(int buffer_length, int block_count);
+  virtual ~AudioReadAhead();
+
+  /*! \brief Start reading a file, unless it is already being read
+   *  following a call to Prefetch(). Blocks until the file has been opened.
+   *  \return true on success, false if the file couldn't be opened.
+   */
+  bool OpenFile(const string &filename, int *channels, float *sample_rate);
+
+  /*! \brief Start reading the given file as soon as the current one has
+   *  been read to the end
+   */
+  void Prefetch(const string &filename);
+
+  /*! \brief Return the next block of the current file, waiting for it to be
+   *  decoded if necessary. A block with fewer than buffer_length frames
+   *  marks the end of the file. Returns NULL once the end block has been
+   *  returned, or if no file is open. Each block must be passed back to
+   *  RecycleBlock() once it has been used.
+   */
+  Block *NextBlock();
+  void RecycleBlock(Block *block);
+
+  /*! \brief Stop the background thread
+   */
+  void Stop();
+
+ protected:
+  virtual void Run();
+
+ private:
+  struct Job {
+    int id;
+    string filename;
+  };
+
+  /*! \brief Wait for a free block for the given job. Returns NULL if the
+   *  reader is stopping or the job has been abandoned. mutex_ must be held.
+   */
+  Block *AcquireBlock(int job);
+
+  /*! \brief Pass a decoded block to the consumer. mutex_ must be held.
+   */
+  void PublishBlock(Block *block);
+
+  /*! \brief Wait for the next block of the current job, recycling any
+   *  blocks of abandoned jobs. mutex_ must be held.
+   */
+  Block *WaitForBlock();
+
+  int buffer_length_;
+  vector<Block> blocks_;
+
+  /*! \brief Everything below is guarded by mutex_
+   */
+  Mutex mutex_;
+  ConditionVariable condition_;
+  bool stopping_;
+  deque<Job> jobs_;
+  deque<Block*> ready_blocks_;
+  vector<Block*> free_blocks_;
+  int last_job_;
+  int current_job_;
+  bool current_job_finished_;
+  int prefetch_job_;
+  string prefetch_filename_;
+
+  /*! \brief Header information for each job, filled in when the file is
+   *  opened
+   */
+  int opened_job_;
+  bool opened_ok_;
+  int opened_channels_;
+  float opened_sample_rate_;
+};
+}  // namespace aimc
+
+#endif  // AIMC_MODULES_INPUT_AUDIOREADAHEAD_H_
@@ -0,0 +1,229 @@
+// Copyright 2026, agent
+//
+// AIM-C: A C++ implementation of the Auditory Image Model
+// http://www.acousticscale.org/AIMC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*! \author agent <agent@local>
+ *  \date 2026/10/19
+ *  \version \$Id$
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "Modules/Input/MappedAudioFile.h"
+
+namespace aimc {
+// WAVE_FORMAT_* tags in the fmt chunk
+static const int kWaveFormatPCM = 1;
+static const int kWaveFormatFloat = 3;
+static const int kWaveFormatExtensible = 0xFFFE;
+
+// Read little-endian integers from a possibly unaligned position
+static unsigned int ReadLE16(const char *p) {
+  const unsigned char *b = reinterpret_cast<const unsigned char*>(p);
+  return b[0] | (b[1] << 8);
+}
+
+static unsigned int ReadLE32(const char *p) {
+  const unsigned char *b = reinterpret_cast<const unsigned char*>(p);
+  return b[0] | (b[1] << 8) | (b[2] << 16)
+         | (static_cast<unsigned int>(b[3]) << 24);
+}
+
+// The samples are converted in place, so the host must share the file's
+// byte order
+static bool HostIsLittleEndian() {
+  uint16_t value = 1;
+  return *reinterpret_cast<char*>(&value) == 1;
+}
+
+MappedAudioFile::MappedAudioFile()
+    : channels_(0),
+      sample_rate_(0.0f),
+      frame_count_(0),
+      encoding_(kPCM16),
+      data_(NULL),
+      mapping_(NULL),
+      mapping_length_(0),
+      raw_channels_(1),
+      raw_sample_rate_(48000.0f),
+      raw_encoding_(kPCM16) {
+}
+
+MappedAudioFile::~MappedAudioFile() {
+  Close();
+}
+
+void MappedAudioFile::SetRawFormat(int channels, float sample_rate,
+                                   Encoding encoding) {
+  raw_channels_ = channels;
+  raw_sample_rate_ = sample_rate;
+  raw_encoding_ = encoding;
+}
+
+bool MappedAudioFile::Open(const string &filename) {
+  Close();
+  if (!HostIsLittleEndian()) {
+    return false;
+  }
+
+  if (!file_.Open(filename, true)) {
+    return false;
+  }
+  mapping_ = file_.data();
+  mapping_length_ = file_.size();
+
+  bool raw = false;
+  size_t dot = filename.rfind('.');
+  if (dot != string::npos) {
+    string extension = filename.substr(dot);
+    raw = (extension.compare(".raw") == 0 || extension.compare(".pcm") == 0);
+  }
+
+  bool ok;
+  if (raw) {
+    channels_ = raw_channels_;
+    sample_rate_ = raw_sample_rate_;
+    encoding_ = raw_encoding_;
+    data_ = mapping_;
+    int frame_size = channels_ * (encoding_ == kPCM16 ? 2 : 4);
+    ok = (channels_ > 0);
+    if (ok) {
+      frame_count_ = mapping_length_ / frame_size;
+    }
+  } else {
+    ok = ParseWav();
+  }
+
+  if (!ok) {
+    Close();
+    return false;
+  }
+  return true;
+}
+
+bool MappedAudioFile::ParseWav() {
+  if (mapping_length_ < 12 || memcmp(mapping_, "RIFF", 4) != 0
+      || memcmp(mapping_ + 8, "WAVE", 4) != 0) {
+    return false;
+  }
+
+  bool have_format = false;
+  int block_align = 0;
+  size_t position = 12;
+  while (position + 8 <= mapping_length_) {
+    const char *chunk = mapping_ + position;
+    size_t chunk_length = ReadLE32(chunk + 4);
+    size_t available = mapping_length_ - position - 8;
+    if (memcmp(chunk, "fmt ", 4) == 0) {
+      if (chunk_length < 16 || chunk_length > available) {
+        return false;
+      }
+      int format = ReadLE16(chunk + 8);
+      channels_ = ReadLE16(chunk + 10);
+      sample_rate_ = ReadLE32(chunk + 12);
+      block_align = ReadLE16(chunk + 20);
+      int bits = ReadLE16(chunk + 22);
+      if (format == kWaveFormatExtensible) {
+        // The format is given by the first two bytes of the sub-format GUID
+        if (chunk_length < 40) {
+          return false;
+        }
+        format = ReadLE16(chunk + 32);
+      }
+      if (format == kWaveFormatPCM && bits == 16) {
+        encoding_ = kPCM16;
+      } else if (format == kWaveFormatFloat && bits == 32) {
+        encoding_ = kFloat32;
+      } else {
+        return false;
+      }
+      if (channels_ < 1 || block_align != channels_ * bits / 8) {
+        return false;
+      }
+      have_format = true;
+    } else if (memcmp(chunk, "data", 4) == 0) {
+      if (!have_format) {
+        return false;
+      }
+      // Files which were never finished may claim more data than they hold
+      if (chunk_length > available) {
+        chunk_length = available;
+      }
+      data_ = chunk + 8;
+      frame_count_ = chunk_length / block_align;
+      return true;
+    }
+    // Chunks are padded to an even length
+    position += 8 + chunk_length + (chunk_length & 1);
+  }
+  return false;
+}
+
+void MappedAudioFile::Close() {
+  file_.Close();
+  mapping_ = NULL;
+  mapping_length_ = 0;
+  data_ = NULL;
+  channels_ = 0;
+  sample_rate_ = 0.0f;
+  frame_count_ = 0;
+}
+
+int MappedAudioFile::ReadFrames(int start, int count,
+                                SignalBank *output) const {
+  if (data_ == NULL || start >= frame_count_) {
+    return 0;
+  }
+  if (count > frame_count_ - start) {
+    count = frame_count_ - start;
+  }
+
+  // The data needn't be aligned (float WAVs with an 18-byte fmt chunk
+  // start it at offset 46), so each sample is loaded through memcpy(),
+  // which compiles to a plain unaligned load
+  if (encoding_ == kPCM16) {
+    const size_t stride = channels_ * sizeof(int16_t);
+    const char *samples = data_ + static_cast<size_t>(start) * stride;
+    const float scale = 1.0f / 32768.0f;
+    for (int c = 0; c < channels_; ++c) {
+      float *signal = &output->get_mutable_signal(c)[0];
+      const char *source = samples + c * sizeof(int16_t);
+      for (int i = 0; i < count; ++i) {
+        int16_t sample;
+        memcpy(&sample, source + i * stride, sizeof(sample));
+        signal[i] = sample * scale;
+      }
+    }
+  } else {
+    const size_t stride = channels_ * sizeof(float);
+    const char *samples = data_ + static_cast<size_t>(start) * stride;
+    if (channels_ == 1) {
+      memcpy(&output->get_mutable_signal(0)[0], samples,
+             count * sizeof(float));
+    } else {
+      for (int c = 0; c < channels_; ++c) {
+        float *signal = &output->get_mutable_signal(c)[0];
+        const char *source = samples + c * sizeof(float);
+        for (int i = 0; i < count; ++i) {
+          memcpy(&signal[i], source + i * stride, sizeof(float));
+        }
+      }
+    }
+  }
+  return count;
+}
+}  // namespace aimc
@@ -0,0 +1,116 @@
+// Copyright 2026, agent
+//
+// AIM-C: A C++ implementation of the Auditory Image Model
+// http://www.acousticscale.org/AIMC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*! \file
+ *  \brief Memory-mapped reading of uncompressed audio files
+ */
+
+/*! \author agent <agent@local>
+ *  \date 2026/10/19
+ *  \version \$Id$
+ */
+
+#ifndef AIMC_MODULES_INPUT_MAPPEDAUDIOFILE_H_
+#define AIMC_MODULES_INPUT_MAPPEDAUDIOFILE_H_
+
+#include <stddef.h>
+
+#include <string>
+
+#include "Support/Common.h"
+#include "Support/MappedFile.h"
+#include "Support/SignalBank.h"
+
+namespace aimc {
+using std::string;
+
+/*! \brief Reads 16-bit PCM or 32-bit float audio straight out of a
+ *  memory-mapped WAV or headerless raw file.
+ *
+ * Samples are converted and de-interleaved directly from the mapping into
+ * a SignalBank, with the same scaling as libsndfile's sf_readf_float().
+ * Open() fails for any other format, so that the caller can fall back to
+ * libsndfile.
+ */
+class MappedAudioFile {
+ public:
+  enum Encoding {
+    kPCM16,
+    kFloat32
+  };
+
+  MappedAudioFile();
+  ~MappedAudioFile();
+
+  /*! \brief Set the format assumed for files with a .raw or .pcm extension,
+   *  which have no header
+   */
+  void SetRawFormat(int channels, float sample_rate, Encoding encoding);
+
+  /*! \brief Map a file. Any file already open is closed first.
+   *  \return true on success, false if the file couldn't be mapped or isn't
+   *  in a supported format.
+   */
+  bool Open(const string &filename);
+  void Close();
+
+  /*! \brief Convert up to count frames, starting at frame start, into
+   *  samples [0, count) of each channel of output. The output must have at
+   *  least channels() channels of at least count samples.
+   *  \return The number of frames converted, which is less than count at
+   *  the end of the file.
+   */
+  int ReadFrames(int start, int count, SignalBank *output) const;
+
+  int channels() const {
+    return channels_;
+  }
+
+  float sample_rate() const {
+    return sample_rate_;
+  }
+
+  int frame_count() const {
+    return frame_count_;
+  }
+
+ private:
+  /*! \brief Find the format and the data chunk in a RIFF WAVE header
+   */
+  bool ParseWav();
+
+  int channels_;
+  float sample_rate_;
+  int frame_count_;
+  Encoding encoding_;
+
+  /*! \brief Start of the sample data within the mapping
+   */
+  const char *data_;
+
+  MappedFile file_;
+  const char *mapping_;
+  size_t mapping_length_;
+
+  int raw_channels_;
+  float raw_sample_rate_;
+  Encoding raw_encoding_;
+  DISALLOW_COPY_AND_ASSIGN(MappedAudioFile);
+};
+}  // namespace aimc
+
+#endif  // AIMC_MODULES_INPUT_MAPPEDAUDIOFILE_H_
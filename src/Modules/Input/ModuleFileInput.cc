@@ -38,6 +38,46 @@ ModuleFileInput::ModuleFileInput(Parameters *params) : Module(params) {
   file_handle_ = NULL;
   buffer_length_ = parameters_->DefaultInt("input.buffersize", 1024);
 
+  // Number of buffers to decode ahead on a background thread, or 0 to read
+  // each buffer as it is needed. When reading ahead, the start of the next
+  // file in a script (the global parameter next_input_filename) is also
+  // decoded while the current file is being processed.
+  read_ahead_blocks_ = parameters_->DefaultInt("input.read_ahead", 0);
+  read_ahead_ = NULL;
+
+  // Set input.whole_file to true to output each file as a single buffer
+  // holding the whole file, so that the tree runs once per file rather than
+  // once per input.buffersize samples. This suits short files. The buffer
+  // length then changes from file to file, so every module in the tree must
+  // accept a varying buffer length. Whole files aren't read ahead.
+  whole_file_ = parameters_->DefaultBool("input.whole_file", false);
+  if (whole_file_) {
+    read_ahead_blocks_ = 0;
+  }
+
+  // Read uncompressed 16-bit PCM and 32-bit float WAV files directly from a
+  // memory mapping, converting straight into the output. Other formats are
+  // read with libsndfile as usual. Files with a .raw or .pcm extension are
+  // taken to be headerless, in the format given by input.raw_channels,
+  // input.raw_sample_rate and input.raw_format ("pcm16" or "float").
+  use_mmap_ = parameters_->DefaultBool("input.mmap", false);
+  mapped_ = false;
+  if (use_mmap_) {
+    int raw_channels = parameters_->DefaultInt("input.raw_channels", 1);
+    float raw_sample_rate = parameters_->DefaultFloat("input.raw_sample_rate",
+                                                      48000.0f);
+    string raw_format = parameters_->DefaultString("input.raw_format",
+                                                   "pcm16");
+    MappedAudioFile::Encoding raw_encoding = MappedAudioFile::kPCM16;
+    if (raw_format.compare("float") == 0) {
+      raw_encoding = MappedAudioFile::kFloat32;
+    } else if (raw_format.compare("pcm16") != 0) {
+      LOG_ERROR(_T("Unknown raw format '%s'. Using pcm16."),
+                raw_format.c_str());
+    }
+    mapped_file_.SetRawFormat(raw_channels, raw_sample_rate, raw_encoding);
+  }
+
   file_position_samples_ = 0;
   file_loaded_ = false;
   audio_channels_ = 0;
@@ -49,6 +89,10 @@ ModuleFileInput::~ModuleFileInput() {
     sf_close(file_handle_);
     file_handle_ = NULL;
   }
+  if (read_ahead_ != NULL) {
+    delete read_ahead_;
+    read_ahead_ = NULL;
+  }
 }
 
 void ModuleFileInput::ResetInternal() {
@@ -57,6 +101,62 @@ void ModuleFileInput::ResetInternal() {
     sf_close(file_handle_);
     file_handle_ = NULL;
   }
+  mapped_file_.Close();
+  mapped_ = false;
+
+  if (use_mmap_
+      && mapped_file_.Open(global_parameters_->GetString("input_filename"))) {
+    mapped_ = true;
+    file_loaded_ = true;
+    done_ = false;
+    audio_channels_ = mapped_file_.channels();
+    sample_rate_ = mapped_file_.sample_rate();
+    file_position_samples_ = 0;
+    if (whole_file_) {
+      buffer_length_ = mapped_file_.frame_count();
+      if (buffer_length_ < 1) {
+        buffer_length_ = 1;
+      }
+    }
+    if (!CheckAudioFormat()) {
+      return;
+    }
+    output_.Initialize(audio_channels_, buffer_length_, sample_rate_);
+    output_.set_start_time(0);
+    return;
+  }
+
+  if (read_ahead_blocks_ > 0) {
+    if (read_ahead_ == NULL) {
+      read_ahead_ = new AudioReadAhead(buffer_length_, read_ahead_blocks_);
+    }
+    file_loaded_ = false;
+    const char *filename = global_parameters_->GetString("input_filename");
+    int channels = 0;
+    float sample_rate = 0.0f;
+    if (!read_ahead_->OpenFile(filename, &channels, &sample_rate)) {
+      LOG_ERROR(_T("Couldn't read audio file '%s'"), filename);
+      return;
+    }
+    if (global_parameters_->IsSet("next_input_filename")) {
+      string next_filename
+          = global_parameters_->GetString("next_input_filename");
+      if (!next_filename.empty()) {
+        read_ahead_->Prefetch(next_filename);
+      }
+    }
+    file_loaded_ = true;
+    done_ = false;
+    audio_channels_ = channels;
+    sample_rate_ = sample_rate;
+    file_position_samples_ = 0;
+    if (!CheckAudioFormat()) {
+      return;
+    }
+    output_.Initialize(audio_channels_, buffer_length_, sample_rate_);
+    output_.set_start_time(0);
+    return;
+  }
   // Open a file
   SF_INFO sfinfo;
   memset(reinterpret_cast<void*>(&sfinfo), 0, sizeof(SF_INFO));
@@ -79,9 +179,14 @@ void ModuleFileInput::ResetInternal() {
   audio_channels_ = sfinfo.channels;
   sample_rate_ = sfinfo.samplerate;
   file_position_samples_ = 0;
+  if (whole_file_) {
+    buffer_length_ = sfinfo.frames;
+    if (buffer_length_ < 1) {
+      buffer_length_ = 1;
+    }
+  }
 
-  if (audio_channels_ < 1 || buffer_length_ < 1 || sample_rate_ < 0.0f) {
-    LOG_ERROR(_T("Problem with file: audio_channels = %d, buffer_length_ = %d, sample_rate = %f"), audio_channels_, buffer_length_, sample_rate_);
+  if (!CheckAudioFormat()) {
     return;
   }
 
@@ -89,6 +194,16 @@ void ModuleFileInput::ResetInternal() {
   output_.set_start_time(0);
 }
 
+bool ModuleFileInput::CheckAudioFormat() const {
+  if (audio_channels_ < 1 || buffer_length_ < 1 || sample_rate_ < 0.0f) {
+    LOG_ERROR(_T("Problem with file: audio_channels = %d, "
+                 "buffer_length_ = %d, sample_rate = %f"),
+              audio_channels_, buffer_length_, sample_rate_);
+    return false;
+  }
+  return true;
+}
+
 bool ModuleFileInput::InitializeInternal(const SignalBank& input) {
   ResetInternal();
   return true;
@@ -97,6 +212,16 @@ bool ModuleFileInput::InitializeInternal(const SignalBank& input) {
 void ModuleFileInput::Process(const SignalBank& input) {
   if (!file_loaded_)
     return;
+  // The previous buffer may have been a short one
+  output_.SetBufferLength(buffer_length_);
+  if (mapped_) {
+    ProcessMapped();
+    return;
+  }
+  if (read_ahead_blocks_ > 0) {
+    ProcessReadAhead();
+    return;
+  }
   sf_count_t read;
   vector<float> buffer;
   buffer.resize(buffer_length_ * audio_channels_);
@@ -112,26 +237,48 @@ void ModuleFileInput::Process(const SignalBank& input) {
       ++counter;
     }
   }
+  OutputBuffer(read);
+}
 
+void ModuleFileInput::OutputBuffer(int read) {
   // If the number of samples read is less than the buffer length, the end
-  // of the file has been reached.
-  if (read < buffer_length_) {
-    // Zero samples at end
-	for (int i = read; i < buffer_length_; ++i) {
-	  for (int c = 0; c < audio_channels_; ++c) {
-        output_.set_sample(c, i, 0.0f);
-      }
-    }
-    // When we're past the end of the buffer, set the
-    // module state to 'done' and exit.
-    if (read == 0)
-      done_ = true;
-      return;
-  }
+  // of the file has been reached. The last buffer is output at the length
+  // actually read, rather than padded with zeros.
+  if (read < buffer_length_)
+    done_ = true;
+  if (read == 0)
+    return;
 
-  // Update time.
+  output_.SetBufferLength(read);
   output_.set_start_time(file_position_samples_);
   file_position_samples_ += read;
   PushOutput();
 }
+
+void ModuleFileInput::ProcessReadAhead() {
+  AudioReadAhead::Block *block = read_ahead_->NextBlock();
+  if (block == NULL) {
+    done_ = true;
+    return;
+  }
+
+  // Copy each channel of the block straight into the signal bank. The block
+  // is already de-interleaved, so these are contiguous copies.
+  int read = block->frame_count;
+  for (int c = 0; c < audio_channels_; ++c) {
+    vector<float> &signal = output_.get_mutable_signal(c);
+    const float *samples = &block->samples[c * buffer_length_];
+    for (int i = 0; i < read; ++i) {
+      signal[i] = samples[i];
+    }
+  }
+  read_ahead_->RecycleBlock(block);
+  OutputBuffer(read);
+}
+
+void ModuleFileInput::ProcessMapped() {
+  int read = mapped_file_.ReadFrames(file_position_samples_, buffer_length_,
+                                     &output_);
+  OutputBuffer(read);
+}
 }  // namespace aimc
@@ -29,6 +29,8 @@
 
 #include <sndfile.h>
 
+#include "Modules/Input/AudioReadAhead.h"
+#include "Modules/Input/MappedAudioFile.h"
 #include "Support/Module.h"
 #include "Support/Parameters.h"
 #include "Support/SignalBank.h"
@@ -52,10 +54,47 @@ class ModuleFileInput : public Module {
    */
   virtual void ResetInternal();
 
+  /*! \brief Check the channel count, buffer length and sample rate of the
+   *  file which has just been opened, and log an error if they can't be
+   *  used
+   */
+  bool CheckAudioFormat() const;
+
+  /*! \brief Push the read samples of the current buffer, and update the
+   *  position in the file
+   */
+  void OutputBuffer(int read);
+
+  /*! \brief Read the next buffer with the background reader
+   */
+  void ProcessReadAhead();
+
+  /*! \brief Read the next buffer from the memory-mapped file
+   */
+  void ProcessMapped();
+
   /*! \brief File descriptor
    */
   SNDFILE *file_handle_;
 
+  /*! \brief Background reader, used instead of file_handle_ when
+   *  input.read_ahead is set
+   */
+  AudioReadAhead *read_ahead_;
+  int read_ahead_blocks_;
+
+  /*! \brief Memory-mapped file, used instead of file_handle_ when
+   *  input.mmap is set and the file is in a supported format
+   */
+  MappedAudioFile mapped_file_;
+  bool use_mmap_;
+  bool mapped_;
+
+  /*! \brief Output each file as a single buffer, rather than in buffers of
+   *  input.buffersize samples
+   */
+  bool whole_file_;
+
   /*! \brief Current position in time of the file
    */
   int file_position_samples_;
@@ -71,6 +71,7 @@ void ModuleHCL::ResetInternal() {
  * some data will be discarded.
  */
 void ModuleHCL::Process(const SignalBank &input) {
+  output_.SetBufferLength(input.buffer_length());
   output_.set_start_time(input.start_time());
   for (int c = 0; c < input.channel_count(); ++c) {
     for (int i = 0; i < input.buffer_length(); ++i) {
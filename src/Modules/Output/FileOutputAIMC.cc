@@ -41,7 +41,17 @@
 #include <string>
 
 namespace aimc {
-FileOutputAIMC::FileOutputAIMC(Parameters *params) : Module(params) {
+// Size of the header of a version 2 file. The frames start straight after
+// it, so they are aligned for memory-mapped access.
+static const int kHeaderSizeV2 = 64;
+
+// Header flag for version 2 files which contain strobes
+static const uint32_t kHasStrobes = 1;
+
+FileOutputAIMC::FileOutputAIMC(Parameters *params)
+    : Module(params),
+      file_(0),
+      strobes_file_(0) {
   module_description_ = "File output in AIMC format";
   module_identifier_ = "aimc_out";
   module_type_ = "output";
@@ -49,27 +59,45 @@ FileOutputAIMC::FileOutputAIMC(Parameters *params) : Module(params) {
   file_suffix_ = parameters_->DefaultString("file_suffix", ".aimc");
   dump_strobes_ = parameters_->DefaultBool("dump_strobes", false);
   strobes_file_suffix_ = parameters_->DefaultString("strobes_file_suffix", ".strobes");
-
-  file_handle_ = NULL;
-  strobes_file_handle_ = NULL;
+  // Output is written to disk in blocks of this size. Larger values mean
+  // fewer system calls on big runs.
+  int buffer_size_kb = parameters_->DefaultInt("aimc_out.buffer_size_kb", 64);
+  file_.SetBufferSize(buffer_size_kb * 1024);
+  strobes_file_.SetBufferSize(buffer_size_kb * 1024);
+  // Hand full buffers to separate threads, so that processing doesn't wait
+  // for the disk
+  bool background_write = parameters_->DefaultBool(
+      "aimc_out.background_write", false);
+  file_.SetBackgroundWrite(background_write);
+  strobes_file_.SetBackgroundWrite(background_write);
+  // 1 for the original format, 2 for the indexed format with timestamps
+  // and strobes in the same file
+  format_version_ = parameters_->DefaultInt("aimc_out.format_version", 1);
+  if (format_version_ != 1 && format_version_ != 2) {
+    LOG_ERROR(_T("Unknown AIMC format version %d. Using version 1."),
+              format_version_);
+    format_version_ = 1;
+  }
   header_written_ = false;
   frame_period_ms_ = 0.0f;
+  previous_start_time_ = 0;
+  data_size_ = 0;
 }
 
 FileOutputAIMC::~FileOutputAIMC() {
-  if (file_handle_ != NULL)
+  if (file_.is_open())
     CloseFile();
-  if (strobes_file_handle_ != NULL)
+  if (strobes_file_.is_open())
       CloseStrobesFile();
 }
 
 bool FileOutputAIMC::OpenStrobesFile(string &filename) {
-  if (strobes_file_handle_ != NULL) {
+  if (strobes_file_.is_open()) {
     LOG_ERROR(_T("Couldn't open strobes output file. A file is already open."));
     return false;
   }
   // Check that the output file exists and is writeable
-  if ((strobes_file_handle_ = fopen(filename.c_str(), "wb")) == NULL) {
+  if (!strobes_file_.Open(filename)) {
     LOG_ERROR(_T("Couldn't open output file '%s' for writing."), filename.c_str());
     return false;
   }
@@ -77,19 +105,25 @@ bool FileOutputAIMC::OpenStrobesFile(string &filename) {
 }
 
 bool FileOutputAIMC::OpenFile(string &filename) {
-  if (file_handle_ != NULL) {
+  if (file_.is_open()) {
     LOG_ERROR(_T("Couldn't open output file. A file is already open."));
     return false;
   }
 
   // Check that the output file exists and is writeable
-  if ((file_handle_ = fopen(filename.c_str(), "wb")) == NULL) {
+  if (!file_.Open(filename)) {
     LOG_ERROR(_T("Couldn't open output file '%s' for writing."), filename.c_str());
     return false;
   }
   // Write temporary values for the frame count and frame period.
   frame_count_ = 0;
   frame_period_ms_ = 0.0;
+  previous_start_time_ = 0;
+  data_size_ = 0;
+  timestamps_.clear();
+  frame_offsets_.clear();
+  strobe_rows_.assign(1, 0);
+  strobe_values_.clear();
   header_written_ = false;
   if (initialized_) {
     WriteHeader();
@@ -103,25 +137,30 @@ bool FileOutputAIMC::InitializeInternal(const SignalBank &input) {
   buffer_length_ = input.buffer_length();  
   sample_rate_ = input.sample_rate();
   ResetInternal();
-  if (file_handle_ == NULL) {
+  if (!file_.is_open()) {
     LOG_ERROR(_T("Couldn't initialize file output."));
     return false;
   }
+  // The first file was opened before the module counted as initialized
+  if (!header_written_) {
+    WriteHeader();
+  }
   return true;
 }
 
 void FileOutputAIMC::ResetInternal() {
-  if (file_handle_ != NULL && !header_written_) {
+  if (file_.is_open() && !header_written_) {
     WriteHeader();
   }
-  if (file_handle_ != NULL)
+  if (file_.is_open())
     CloseFile();
     
   string out_filename;
   out_filename = global_parameters_->GetString("output_filename_base") + file_suffix_;
   OpenFile(out_filename);
-  if (dump_strobes_) {
-    if (strobes_file_handle_ != NULL) {
+  // Version 2 files hold their own strobes
+  if (dump_strobes_ && format_version_ == 1) {
+    if (strobes_file_.is_open()) {
       CloseStrobesFile();
     }
     string strobes_filename =
@@ -144,26 +183,87 @@ void FileOutputAIMC::WriteHeader() {
    *
    * Data: Series of floats, by time, then channel, then frame
    * f1c1t1,f1c1t2,f1c1t3...
+   *
+   * Version 2 files have a 64-byte header:
+   *   0  Magic number "AIMC" (4 chars)
+   *   4  Format version, 2 (uint32)
+   *   8  Header size in bytes, 64 (uint32)
+   *  12  Flags: 1 if the file contains strobes (uint32)
+   *  16  Number of frames (uint32)
+   *  20  Number of channels per frame (uint32)
+   *  24  Number of samples per channel of each frame (uint32)
+   *  28  Sample rate (float32)
+   *  32  Frame period in milliseconds (float32)
+   *  36  Compression, always 0 for none (uint32)
+   *  40  Offset of the timestamps (uint64)
+   *  48  Offset of the frame index (uint64)
+   *  56  Offset of the strobes, or 0 if there are none (uint64)
+   * The frames follow the header, as in version 1. The remaining sections
+   * start on 8-byte boundaries:
+   *   Timestamps: start time of each frame in samples (int64 per frame)
+   *   Frame index: offset of each frame in the file (uint64 per frame)
+   *   Strobes, in compressed sparse row form: the strobes of channel c of
+   *     frame f are values[rows[f * channels + c]] up to
+   *     values[rows[f * channels + c + 1]], where rows is
+   *     (frames * channels + 1) uint64s and values, which follows it, is
+   *     int32s
+   * Fields which aren't known until the file is finished are filled in when
+   * it is closed.
    */
 
+  if (format_version_ == 2) {
+    char header[kHeaderSizeV2];
+    MakeHeaderV2(0, 0, 0, header);
+    file_.Write(header, sizeof(header));
+    header_written_ = true;
+    return;
+  }
+
   uint32_t frame_count_out = frame_count_;
   float sample_period_out = frame_period_ms_;
   uint32_t channels_out = channel_count_;
   uint32_t samples_out = buffer_length_;
   float sample_rate = sample_rate_;
 
-  fwrite(&frame_count_out, sizeof(frame_count_out), 1, file_handle_);
-  fwrite(&sample_period_out, sizeof(sample_period_out), 1, file_handle_);
-  fwrite(&channels_out, sizeof(channels_out), 1, file_handle_);
-  fwrite(&samples_out, sizeof(samples_out), 1, file_handle_);
-  fwrite(&sample_rate, sizeof(sample_rate), 1, file_handle_);
-  fflush(file_handle_);
+  file_.Write(&frame_count_out, sizeof(frame_count_out));
+  file_.Write(&sample_period_out, sizeof(sample_period_out));
+  file_.Write(&channels_out, sizeof(channels_out));
+  file_.Write(&samples_out, sizeof(samples_out));
+  file_.Write(&sample_rate, sizeof(sample_rate));
 
   header_written_ = true;
 }
 
+void FileOutputAIMC::MakeHeaderV2(uint64_t timestamps_offset,
+                                  uint64_t frame_index_offset,
+                                  uint64_t strobes_offset,
+                                  char *header) const {
+  memset(header, 0, kHeaderSizeV2);
+  uint32_t version = 2;
+  uint32_t header_size = kHeaderSizeV2;
+  uint32_t flags = (strobes_offset != 0) ? kHasStrobes : 0;
+  uint32_t frame_count = frame_count_;
+  uint32_t channels_out = channel_count_;
+  uint32_t samples_out = buffer_length_;
+  float sample_rate = sample_rate_;
+  float frame_period = frame_period_ms_;
+  memcpy(header, "AIMC", 4);
+  memcpy(header + 4, &version, sizeof(version));
+  memcpy(header + 8, &header_size, sizeof(header_size));
+  memcpy(header + 12, &flags, sizeof(flags));
+  memcpy(header + 16, &frame_count, sizeof(frame_count));
+  memcpy(header + 20, &channels_out, sizeof(channels_out));
+  memcpy(header + 24, &samples_out, sizeof(samples_out));
+  memcpy(header + 28, &sample_rate, sizeof(sample_rate));
+  memcpy(header + 32, &frame_period, sizeof(frame_period));
+  // Bytes 36-39 give the compression, which is always none
+  memcpy(header + 40, &timestamps_offset, sizeof(timestamps_offset));
+  memcpy(header + 48, &frame_index_offset, sizeof(frame_index_offset));
+  memcpy(header + 56, &strobes_offset, sizeof(strobes_offset));
+}
+
 void FileOutputAIMC::Process(const SignalBank &input) {
-  if (file_handle_ == NULL) {
+  if (!file_.is_open()) {
     LOG_ERROR(_T("Couldn't process file output. No file is open."
                  "Please call FileOutputAIMC::OpenFile first"));
     return;
@@ -175,66 +275,134 @@ void FileOutputAIMC::Process(const SignalBank &input) {
                  "FileOutputAIMC::Process()"));
     return;
   }
-  float s;
 
-  for (int ch = 0; ch < input.channel_count(); ch++) {
-    for (int i = 0; i < input.buffer_length(); i++) {
-      s = input.sample(ch, i);
-      fwrite(&s, sizeof(s), 1, file_handle_);
-    }
+  // The header gives a single frame size for the whole file, so a buffer of
+  // any other length (such as the short final buffer of an input file) can't
+  // be written
+  if (input.buffer_length() != buffer_length_
+      || input.channel_count() != channel_count_) {
+    return;
+  }
+
+  if (frame_count_ > 0) {
+    frame_period_ms_ = 1000.0
+                       * (input.start_time() - previous_start_time_)
+                       / input.sample_rate();
+  }
+  previous_start_time_ = input.start_time();
+
+  size_t channel_size = buffer_length_ * sizeof(float);
+  for (int ch = 0; ch < channel_count_; ch++) {
+    file_.Write(&input[ch][0], channel_size);
   }
   frame_count_++;
+
+  if (format_version_ == 2) {
+    timestamps_.push_back(input.start_time());
+    frame_offsets_.push_back(kHeaderSizeV2 + data_size_);
+    data_size_ += channel_count_ * channel_size;
+    if (dump_strobes_) {
+      for (int ch = 0; ch < channel_count_; ch++) {
+        const vector<int> &strobes = input.get_strobes(ch);
+        strobe_values_.insert(strobe_values_.end(), strobes.begin(),
+                              strobes.end());
+        strobe_rows_.push_back(strobe_values_.size());
+      }
+    }
+    return;
+  }
   
   if (dump_strobes_) {
-    if (strobes_file_handle_ == NULL) {
+    if (!strobes_file_.is_open()) {
       LOG_ERROR(_T("Couldn't process file output for strobes. No srobes file is open."
                    "Please call FileOutputAIMC::OpenStrobesFile first"));
       return;
     }
-    int strobe;
+    const int kStartOfStrobeRow = -65535;
     for (int ch = 0; ch < input.channel_count(); ch++) {
-      const int kStartOfStrobeRow = -65535;
-      strobe = kStartOfStrobeRow;
-      fwrite(&strobe, sizeof(strobe), 1, strobes_file_handle_);
-      for (int i = 0; i < static_cast<int>(input.get_strobes(ch).size());
-           i++) {
-        strobe = input.get_strobes(ch)[i];
-        fwrite(&strobe, sizeof(strobe), 1, strobes_file_handle_);
+      const vector<int> &strobes = input.get_strobes(ch);
+      size_t strobes_size = strobes.size() * sizeof(int);
+      char *row = strobes_file_.Reserve(sizeof(int) + strobes_size);
+      memcpy(row, &kStartOfStrobeRow, sizeof(int));
+      if (!strobes.empty()) {
+        memcpy(row + sizeof(int), &strobes[0], strobes_size);
       }
-    } 
+    }
   }
   
 }
 
 bool FileOutputAIMC::CloseStrobesFile() {
-  if (strobes_file_handle_ == NULL)
+  if (!strobes_file_.is_open())
     return false;
 
   // And close the file
-  fclose(strobes_file_handle_);
-  strobes_file_handle_ = NULL;
-  return true;
+  return strobes_file_.Close();
 }
 
 bool FileOutputAIMC::CloseFile() {
-  if (file_handle_ == NULL)
+  if (!file_.is_open())
     return false;
 
-  // Write the first 4 bytes of the file
-  // with how many samples there are in the file
-  fflush(file_handle_);
-  rewind(file_handle_);
-  fflush(file_handle_);
-  uint32_t frame_count = frame_count_;
-  float sample_period_out = frame_period_ms_;
-  fwrite(&frame_count, sizeof(frame_count), 1, file_handle_);
-  fwrite(&sample_period_out, sizeof(sample_period_out), 1, file_handle_);
+  if (format_version_ == 2) {
+    FinishFileV2();
+  } else {
+    // Write the first 4 bytes of the file
+    // with how many samples there are in the file
+    char header[sizeof(uint32_t) + sizeof(float)];
+    uint32_t frame_count = frame_count_;
+    float sample_period_out = frame_period_ms_;
+    memcpy(header, &frame_count, sizeof(frame_count));
+    memcpy(header + sizeof(frame_count), &sample_period_out,
+           sizeof(sample_period_out));
+    file_.Overwrite(0, header, sizeof(header));
+  }
 
   // And close the file
-  fclose(file_handle_);
-  file_handle_ = NULL;
+  bool ok = file_.Close();
+  if (!ok) {
+    LOG_ERROR(_T("Error writing AIMC output file."));
+  }
   header_written_ = false;
-  return true;
+  return ok;
+}
+
+void FileOutputAIMC::FinishFileV2() {
+  uint64_t position = kHeaderSizeV2 + data_size_;
+  // The frames are a whole number of floats, so at most 4 bytes of padding
+  // are needed to align the 64-bit sections
+  if (position % sizeof(uint64_t) != 0) {
+    const char padding[sizeof(uint64_t)] = { 0 };
+    size_t padding_size = sizeof(uint64_t) - position % sizeof(uint64_t);
+    file_.Write(padding, padding_size);
+    position += padding_size;
+  }
+
+  uint64_t timestamps_offset = position;
+  if (!timestamps_.empty()) {
+    file_.Write(&timestamps_[0], timestamps_.size() * sizeof(int64_t));
+  }
+  position += timestamps_.size() * sizeof(int64_t);
+
+  uint64_t frame_index_offset = position;
+  if (!frame_offsets_.empty()) {
+    file_.Write(&frame_offsets_[0], frame_offsets_.size() * sizeof(uint64_t));
+  }
+  position += frame_offsets_.size() * sizeof(uint64_t);
+
+  uint64_t strobes_offset = 0;
+  if (dump_strobes_) {
+    strobes_offset = position;
+    file_.Write(&strobe_rows_[0], strobe_rows_.size() * sizeof(uint64_t));
+    if (!strobe_values_.empty()) {
+      file_.Write(&strobe_values_[0],
+                  strobe_values_.size() * sizeof(int32_t));
+    }
+  }
+
+  char header[kHeaderSizeV2];
+  MakeHeaderV2(timestamps_offset, frame_index_offset, strobes_offset, header);
+  file_.Overwrite(0, header, sizeof(header));
 }
 }  // namespace aimc
 
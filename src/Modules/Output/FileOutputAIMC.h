@@ -28,12 +28,26 @@
 #ifndef AIMC_MODULES_OUTPUT_AIMC_H_
 #define AIMC_MODULES_OUTPUT_AIMC_H_
 
+#include <stdint.h>
+
 #include <string>
+#include <vector>
 
+#include "Support/BufferedFileWriter.h"
 #include "Support/Module.h"
 #include "Support/SignalBank.h"
 
 namespace aimc {
+using std::vector;
+
+/*! \brief Output of frames to a .aimc file.
+ *
+ * Version 1 files have a 20-byte header followed by the frames, with
+ * strobes optionally written to a separate file. Version 2 files, written
+ * when aimc_out.format_version is 2, add per-frame timestamps, a frame
+ * index and the strobes after the frames, and can be memory-mapped. See
+ * WriteHeader() for the layout of both.
+ */
 class FileOutputAIMC : public Module {
  public:
   /*! \brief Create a new file output for an AIMC format file.
@@ -57,14 +71,25 @@ class FileOutputAIMC : public Module {
 
   void WriteHeader();
 
+  /*! \brief Fill in the 64-byte header of a version 2 file
+   */
+  void MakeHeaderV2(uint64_t timestamps_offset, uint64_t frame_index_offset,
+                    uint64_t strobes_offset, char *header) const;
+
+  /*! \brief Write the sections which follow the frames in a version 2 file,
+   *  and fill in the header
+   */
+  void FinishFileV2();
+
   /*! \brief Whether initialization is done or not
    */
   bool header_written_;
 
-  /*! \brief Internal pointer to the output file
+  /*! \brief The output files. Frames are staged in their buffers and reach
+   *  the disk a buffer-full at a time.
    */
-  FILE *file_handle_;
-  FILE *strobes_file_handle_;
+  BufferedFileWriter file_;
+  BufferedFileWriter strobes_file_;
 
   /*! \brief Count of the number of samples in the file, written on close
    */
@@ -77,6 +102,20 @@ class FileOutputAIMC : public Module {
   string file_suffix_;
   bool dump_strobes_;
   string strobes_file_suffix_;
+  int previous_start_time_;
+
+  /*! \brief Version of the file format to write
+   */
+  int format_version_;
+
+  /*! \brief Sections of a version 2 file, which are kept until the file is
+   *  closed
+   */
+  uint64_t data_size_;
+  vector<int64_t> timestamps_;
+  vector<uint64_t> frame_offsets_;
+  vector<uint64_t> strobe_rows_;
+  vector<int32_t> strobe_values_;
 };
 }  // namespace aimc
 
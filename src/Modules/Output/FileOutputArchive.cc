@@ -0,0 +1,190 @@
+// Copyright 2026, agent
+//
+// AIM-C: A C++ implementation of the Auditory Image Model
+// http://www.acousticscale.org/AIMC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*!
+ * \author agent <agent@local>
+ * \date created 2026/10/19
+ * \version \$Id$
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "Modules/Output/FileOutputArchive.h"
+#include "Support/FeatureArchive.h"
+
+namespace aimc {
+FileOutputArchive::FileOutputArchive(Parameters *params)
+    : Module(params),
+      index_file_(0),
+      shard_file_(0) {
+  module_description_ = "Output of all input files to a feature archive";
+  module_identifier_ = "archive_out";
+  module_type_ = "output";
+  module_version_ = "$Id$";
+
+  // The archive is made up of <path>.index and the shard files
+  // <path>.00000.shard, <path>.00001.shard...
+  path_ = parameters_->DefaultString("archive_out.path", "aimc_archive");
+  // A new shard is started when the current one has grown past this size
+  shard_size_ = parameters_->DefaultInt("archive_out.shard_size_mb", 1024);
+  shard_size_ *= 1024 * 1024;
+  int buffer_size_kb = parameters_->DefaultInt("archive_out.buffer_size_kb",
+                                               1024);
+  shard_file_.SetBufferSize(buffer_size_kb * 1024);
+  shard_file_.SetBackgroundWrite(parameters_->DefaultBool(
+      "archive_out.background_write", false));
+  index_file_.SetBufferSize(64 * 1024);
+
+  shard_ = 0;
+  shard_position_ = 0;
+  in_utterance_ = false;
+  utterance_offset_ = 0;
+  frame_count_ = 0;
+  frame_period_ms_ = 0.0f;
+  previous_start_time_ = 0;
+}
+
+FileOutputArchive::~FileOutputArchive() {
+  CloseArchive();
+}
+
+bool FileOutputArchive::InitializeInternal(const SignalBank &input) {
+  channel_count_ = input.channel_count();
+  buffer_length_ = input.buffer_length();
+  sample_rate_ = input.sample_rate();
+
+  CloseArchive();
+  if (!OpenArchive()) {
+    LOG_ERROR(_T("Couldn't initialize archive output."));
+    return false;
+  }
+  StartUtterance();
+  return true;
+}
+
+void FileOutputArchive::ResetInternal() {
+  FinishUtterance();
+  // A Reset() with no output filename comes after the last input file
+  if (global_parameters_->GetString("output_filename_base")[0] == '\0') {
+    CloseArchive();
+  } else {
+    StartUtterance();
+  }
+}
+
+bool FileOutputArchive::OpenArchive() {
+  string index_filename = FeatureArchive::IndexFilename(path_);
+  if (!index_file_.Open(index_filename)) {
+    LOG_ERROR(_T("Couldn't open archive index '%s' for writing."),
+              index_filename.c_str());
+    return false;
+  }
+  const char kFieldNames[] = "# id\tshard\toffset\tframes\tchannels\tsamples"
+                             "\tframe_period_ms\tsample_rate\n";
+  index_file_.Write(kFeatureArchiveHeader, strlen(kFeatureArchiveHeader));
+  index_file_.Write("\n", 1);
+  index_file_.Write(kFieldNames, strlen(kFieldNames));
+  if (!OpenShard(0)) {
+    index_file_.Close();
+    return false;
+  }
+  return true;
+}
+
+bool FileOutputArchive::OpenShard(int shard) {
+  string shard_filename = FeatureArchive::ShardFilename(path_, shard);
+  // Opening the new shard closes the previous one
+  if (!shard_file_.Open(shard_filename)) {
+    LOG_ERROR(_T("Couldn't open archive shard '%s' for writing."),
+              shard_filename.c_str());
+    return false;
+  }
+  shard_ = shard;
+  shard_position_ = 0;
+  return true;
+}
+
+void FileOutputArchive::CloseArchive() {
+  FinishUtterance();
+  if (shard_file_.is_open() && !shard_file_.Close()) {
+    LOG_ERROR(_T("Error writing archive shard %d."), shard_);
+  }
+  if (index_file_.is_open() && !index_file_.Close()) {
+    LOG_ERROR(_T("Error writing archive index."));
+  }
+}
+
+void FileOutputArchive::StartUtterance() {
+  utterance_id_ = global_parameters_->GetString("output_filename_base");
+  in_utterance_ = true;
+  utterance_offset_ = shard_position_;
+  frame_count_ = 0;
+  frame_period_ms_ = 0.0f;
+  previous_start_time_ = 0;
+}
+
+void FileOutputArchive::FinishUtterance() {
+  if (!in_utterance_ || !index_file_.is_open()) {
+    in_utterance_ = false;
+    return;
+  }
+  char fields[256];
+  int length = snprintf(fields, sizeof(fields),
+                        "\t%d\t%lld\t%d\t%d\t%d\t%.9g\t%.9g\n", shard_,
+                        utterance_offset_, frame_count_, channel_count_,
+                        buffer_length_, frame_period_ms_, sample_rate_);
+  index_file_.Write(utterance_id_.data(), utterance_id_.size());
+  index_file_.Write(fields, length);
+  in_utterance_ = false;
+}
+
+void FileOutputArchive::Process(const SignalBank &input) {
+  if (!shard_file_.is_open() || !in_utterance_) {
+    LOG_ERROR(_T("Couldn't process archive output. No archive is open."));
+    return;
+  }
+
+  // Every frame of an utterance must have the size given in the index
+  if (input.buffer_length() != buffer_length_
+      || input.channel_count() != channel_count_) {
+    return;
+  }
+
+  if (frame_count_ == 0) {
+    if (shard_position_ >= shard_size_ && shard_position_ > 0) {
+      if (!OpenShard(shard_ + 1)) {
+        in_utterance_ = false;
+        return;
+      }
+    }
+    utterance_offset_ = shard_position_;
+  } else {
+    frame_period_ms_ = 1000.0
+                       * (input.start_time() - previous_start_time_)
+                       / input.sample_rate();
+  }
+  previous_start_time_ = input.start_time();
+
+  size_t channel_size = buffer_length_ * sizeof(float);
+  for (int ch = 0; ch < channel_count_; ++ch) {
+    shard_file_.Write(&input[ch][0], channel_size);
+  }
+  shard_position_ += channel_count_ * channel_size;
+  ++frame_count_;
+}
+}  // namespace aimc
@@ -0,0 +1,98 @@
+// Copyright 2026, agent
+//
+// AIM-C: A C++ implementation of the Auditory Image Model
+// http://www.acousticscale.org/AIMC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*! \file
+ *  \brief Output of every utterance in a run to a single feature archive
+ */
+
+/*!
+ * \author agent <agent@local>
+ * \date created 2026/10/19
+ * \version \$Id$
+ */
+
+#ifndef AIMC_MODULES_OUTPUT_ARCHIVE_H_
+#define AIMC_MODULES_OUTPUT_ARCHIVE_H_
+
+#include <string>
+
+#include "Support/BufferedFileWriter.h"
+#include "Support/Module.h"
+#include "Support/SignalBank.h"
+
+namespace aimc {
+using std::string;
+
+/*! \brief Appends the frames of each input file to a few large shard
+ *  files, in the format read by FeatureArchive, instead of writing a file
+ *  per input.
+ *
+ * Each input file becomes one utterance, identified by the
+ * output_filename_base global parameter. Utterances are never split
+ * between shards; a new shard is started once the current one reaches
+ * archive_out.shard_size_mb.
+ */
+class FileOutputArchive : public Module {
+ public:
+  explicit FileOutputArchive(Parameters *pParam);
+  virtual ~FileOutputArchive();
+  virtual void Process(const SignalBank &input);
+
+ private:
+  /*! \brief Start a new archive, replacing any existing archive at the same
+   *  path
+   */
+  virtual bool InitializeInternal(const SignalBank &input);
+
+  /*! \brief Finish the current utterance and start the next, or close the
+   *  archive once there are no more input files
+   */
+  virtual void ResetInternal();
+
+  bool OpenArchive();
+  void CloseArchive();
+  bool OpenShard(int shard);
+  void StartUtterance();
+
+  /*! \brief Add the current utterance to the index
+   */
+  void FinishUtterance();
+
+  string path_;
+  long long shard_size_;
+
+  BufferedFileWriter index_file_;
+  BufferedFileWriter shard_file_;
+  int shard_;
+  long long shard_position_;
+
+  /*! \brief Details of the utterance being written
+   */
+  bool in_utterance_;
+  string utterance_id_;
+  long long utterance_offset_;
+  int frame_count_;
+  float frame_period_ms_;
+  int previous_start_time_;
+
+  int channel_count_;
+  int buffer_length_;
+  float sample_rate_;
+};
+}  // namespace aimc
+
+#endif  // AIMC_MODULES_OUTPUT_ARCHIVE_H_
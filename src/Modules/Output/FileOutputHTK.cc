@@ -40,22 +40,44 @@
 #include "Modules/Output/FileOutputHTK.h"
 
 namespace aimc {
-FileOutputHTK::FileOutputHTK(Parameters *params) : Module(params) {
+// Convert native (little-endian) floats to the big-endian order used in HTK
+// files. Written as a plain loop over whole words so that the compiler can
+// vectorize it.
+static void FloatsToBigEndian(const float *input, int count, char *output) {
+  for (int i = 0; i < count; ++i) {
+    uint32_t word;
+    memcpy(&word, &input[i], sizeof(word));
+    word = ByteSwap32(word);
+    memcpy(&output[i * sizeof(word)], &word, sizeof(word));
+  }
+}
+
+FileOutputHTK::FileOutputHTK(Parameters *params)
+    : Module(params),
+      file_(0) {
   module_description_ = "File output in HTK format";
   module_identifier_ = "htk_out";
   module_type_ = "output";
   module_version_ = "$Id$";
   
   file_suffix_ = parameters_->DefaultString("htk_out.file_suffix", ".htk");
+  // Output is written to disk in blocks of this size. Larger values mean
+  // fewer system calls on big runs.
+  int buffer_size_kb = parameters_->DefaultInt("htk_out.buffer_size_kb", 64);
+  file_.SetBufferSize(buffer_size_kb * 1024);
+  // Hand full buffers to a separate thread, so that processing doesn't wait
+  // for the disk
+  bool background_write = parameters_->DefaultBool(
+      "htk_out.background_write", false);
+  file_.SetBackgroundWrite(background_write);
 
-  file_handle_ = NULL;
   header_written_ = false;
   frame_period_ms_ = 0.0f;
   previous_start_time_ = 0;
 }
 
 FileOutputHTK::~FileOutputHTK() {
-  if (file_handle_ != NULL)
+  if (file_.is_open())
     CloseFile();
 }
 
@@ -63,7 +85,7 @@ bool FileOutputHTK::InitializeInternal(const SignalBank &input) {
   channel_count_ = input.channel_count();
   buffer_length_ = input.buffer_length();
   ResetInternal();
-  if (file_handle_ == NULL) {
+  if (!file_.is_open()) {
     LOG_ERROR(_T("Couldn't initialize file output."));
     return false;
   }
@@ -76,18 +98,17 @@ bool FileOutputHTK::InitializeInternal(const SignalBank &input) {
 
 void FileOutputHTK::ResetInternal() {
   // Finalize and close the open file, if there is one.
-  if (file_handle_ != NULL && !header_written_) {
+  if (file_.is_open() && !header_written_) {
     WriteHeader(channel_count_ * buffer_length_);
   }
-  if (file_handle_ != NULL)
+  if (file_.is_open())
     CloseFile();
     
   // Now open and set up the new file.
   // Check that the output file exists and is writeable.
   string out_filename;
   out_filename = global_parameters_->GetString("output_filename_base") + file_suffix_;
-  if ((file_handle_ = fopen(out_filename.c_str(),
-                            "wb")) == NULL) {
+  if (!file_.Open(out_filename)) {
     LOG_ERROR(_T("Couldn't open output file '%s' for writing."),
               out_filename.c_str());
     return;
@@ -126,17 +147,16 @@ void FileOutputHTK::WriteHeader(int num_elements) {
 
   // Enter header values. sample_count is a dummy value which is filled in on
   // file close
-  fwrite(&sample_count, sizeof(sample_count), 1, file_handle_);
-  fwrite(&sample_period, sizeof(sample_period), 1, file_handle_);
-  fwrite(&sample_size, sizeof(sample_size), 1, file_handle_);
-  fwrite(&parameter_kind, sizeof(parameter_kind), 1, file_handle_);
-  fflush(file_handle_);
+  file_.Write(&sample_count, sizeof(sample_count));
+  file_.Write(&sample_period, sizeof(sample_period));
+  file_.Write(&sample_size, sizeof(sample_size));
+  file_.Write(&parameter_kind, sizeof(parameter_kind));
 
   header_written_ = true;
 }
 
 void FileOutputHTK::Process(const SignalBank &input) {
-  if (file_handle_ == NULL) {
+  if (!file_.is_open()) {
     LOG_ERROR(_T("Couldn't process file output. No file is open."
                  "Please call FileOutputHTK::OpenFile first"));
     return;
@@ -148,14 +168,20 @@ void FileOutputHTK::Process(const SignalBank &input) {
                  "before calling FileOutputHTK::Process()"));
     return;
   }
-  float s;
-
-  for (int ch = 0; ch < input.channel_count(); ch++) {
-    for (int i = 0; i < input.buffer_length(); i++) {
-      s = input.sample(ch, i);
-      s = ByteSwapFloat(s);
-      fwrite(&s, sizeof(s), 1, file_handle_);
-    }
+
+  // HTK files hold vectors of a fixed size, so a buffer of any other length
+  // (such as the short final buffer of an input file) can't be written
+  if (input.buffer_length() != buffer_length_
+      || input.channel_count() != channel_count_) {
+    return;
+  }
+
+  // The whole frame is converted straight into the output buffer
+  size_t channel_size = buffer_length_ * sizeof(float);
+  char *frame = file_.Reserve(channel_count_ * channel_size);
+  for (int ch = 0; ch < channel_count_; ch++) {
+    FloatsToBigEndian(&input[ch][0], buffer_length_,
+                      frame + ch * channel_size);
   }
   sample_count_++;
   frame_period_ms_ = 1000.0
@@ -165,41 +191,25 @@ void FileOutputHTK::Process(const SignalBank &input) {
 }
 
 bool FileOutputHTK::CloseFile() {
-  if (file_handle_ == NULL)
+  if (!file_.is_open())
     return false;
 
   // Write the first 4 bytes of the file
   // with how many samples there are in the file
   // and the next 4 bytes with the frame period.
-  fflush(file_handle_);
-  rewind(file_handle_);
-  fflush(file_handle_);
-  int32_t samples = sample_count_;
-  samples = ByteSwap32(samples);
+  int32_t header[2];
+  header[0] = ByteSwap32(sample_count_);
   int32_t sample_period = floor(1e4 * frame_period_ms_);
-  sample_period = ByteSwap32(sample_period);
-  fwrite(&samples, sizeof(samples), 1, file_handle_);
-  fwrite(&sample_period, sizeof(sample_period), 1, file_handle_);
+  header[1] = ByteSwap32(sample_period);
+  file_.Overwrite(0, header, sizeof(header));
 
   // And close the file
-  fclose(file_handle_);
-  file_handle_ = NULL;
+  bool ok = file_.Close();
+  if (!ok) {
+    LOG_ERROR(_T("Error writing HTK output file."));
+  }
   header_written_ = false;
-  return true;
-}
-
-float FileOutputHTK::ByteSwapFloat(float d) {
-  // Endianness fix
-  float a;
-  unsigned char *dst = (unsigned char *)&a;
-  unsigned char *src = (unsigned char *)&d;
-
-  dst[0] = src[3];
-  dst[1] = src[2];
-  dst[2] = src[1];
-  dst[3] = src[0];
-
-  return a;
+  return ok;
 }
 }  // namespace aimc
 
@@ -30,6 +30,7 @@
 
 #include <string>
 
+#include "Support/BufferedFileWriter.h"
 #include "Support/Module.h"
 #include "Support/SignalBank.h"
 
@@ -91,17 +92,16 @@ class FileOutputHTK : public Module {
   virtual bool InitializeInternal(const SignalBank &input);
   virtual void ResetInternal();
 
-  float ByteSwapFloat(float d);
-
   void WriteHeader(int nelements);
 
   /*! \brief Whether initialization is done or not
    */
   bool header_written_;
 
-  /*! \brief Internal pointer to the output file
+  /*! \brief The output file. Frames are staged in its buffer and reach the
+   *  disk a buffer-full at a time.
    */
-  FILE *file_handle_;
+  BufferedFileWriter file_;
 
   /*! \brief Count of the number of samples in the file, written on close
    */
@@ -26,8 +26,6 @@
  */
 
 
-#include <iostream>
-#include <fstream>
 #include <iomanip>
 
 #include "Modules/Output/FileOutputJSON.h"
@@ -39,31 +37,207 @@
 #  include <dirent.h>  // for opendir & friends
 #endif
 
+#include <float.h>
+#include <math.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <cmath>
 #include <string>
 
 namespace aimc {
-FileOutputJSON::FileOutputJSON(Parameters *params) : Module(params) {
+// Powers of ten which are exactly representable as doubles
+static const double kPowersOfTen[] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13,
+  1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+static const int kMaxExactPower = 22;
+
+// Return true if value lies exactly half way between two normal floats.
+// Floats have 24 significant bits to a double's 53, so the 29 lowest bits of
+// such a double are a one followed by zeros.
+static bool IsFloatMidpoint(double value) {
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return (bits & 0x1fffffff) == 0x10000000;
+}
+
+// Each candidate of 1 to 9 significant digits is checked with a single
+// correctly rounded double operation, which can only disagree with a
+// correctly rounding parser when the result is exactly half way between two
+// floats. Such candidates, and values too large or small for the
+// arithmetic to be exact, fall back to the much slower printf and strtod.
+int FormatFloat(float value, char *out) {
+  // JSON has no representation of infinity or NaN
+  if (value != value || value > FLT_MAX || value < -FLT_MAX) {
+    memcpy(out, "null", 4);
+    return 4;
+  }
+  if (value == 0.0f) {
+    out[0] = '0';
+    return 1;
+  }
+  char *p = out;
+  if (value < 0.0f) {
+    *p++ = '-';
+    value = -value;
+  }
+
+  // value is close to digits * 10^-scale
+  double exact = value;
+  int exponent = static_cast<int>(floor(log10(exact)));
+  uint64_t digits = 0;
+  int scale = 0;
+  bool found = false;
+  for (int precision = 1; precision <= 9; ++precision) {
+    scale = precision - 1 - exponent;
+    if (scale > kMaxExactPower || scale < -kMaxExactPower) {
+      break;
+    }
+    double candidate;
+    if (scale >= 0) {
+      digits = static_cast<uint64_t>(exact * kPowersOfTen[scale] + 0.5);
+      candidate = digits / kPowersOfTen[scale];
+    } else {
+      digits = static_cast<uint64_t>(exact / kPowersOfTen[-scale] + 0.5);
+      candidate = digits * kPowersOfTen[-scale];
+    }
+    if (IsFloatMidpoint(candidate)) {
+      break;
+    }
+    if (static_cast<float>(candidate) == value) {
+      found = true;
+      break;
+    }
+  }
+  if (!found) {
+    // 9 significant digits always round trip
+    int length = 0;
+    for (int precision = 1; precision <= 9; ++precision) {
+      length = snprintf(p, 32 - (p - out), "%.*g", precision, value);
+      if (static_cast<float>(strtod(p, NULL)) == value) {
+        break;
+      }
+    }
+    return (p - out) + length;
+  }
+
+  while (digits % 10 == 0) {
+    digits /= 10;
+    --scale;
+  }
+  char digit_text[24];
+  int count = 0;
+  for (uint64_t d = digits; d > 0; d /= 10) {
+    digit_text[count++] = '0' + d % 10;
+  }
+  // Digits are generated last first
+  for (int i = 0; i < count / 2; ++i) {
+    char c = digit_text[i];
+    digit_text[i] = digit_text[count - 1 - i];
+    digit_text[count - 1 - i] = c;
+  }
+
+  // Number of digits before the decimal point
+  int point = count - scale;
+  if (point > 0 && point <= 21) {
+    for (int i = 0; i < point; ++i) {
+      *p++ = (i < count) ? digit_text[i] : '0';
+    }
+    if (point < count) {
+      *p++ = '.';
+      memcpy(p, digit_text + point, count - point);
+      p += count - point;
+    }
+  } else if (point <= 0 && point > -6) {
+    *p++ = '0';
+    *p++ = '.';
+    for (int i = point; i < 0; ++i) {
+      *p++ = '0';
+    }
+    memcpy(p, digit_text, count);
+    p += count;
+  } else {
+    *p++ = digit_text[0];
+    if (count > 1) {
+      *p++ = '.';
+      memcpy(p, digit_text + 1, count - 1);
+      p += count - 1;
+    }
+    p += snprintf(p, 8, "e%d", point - 1);
+  }
+  return p - out;
+}
+
+// Append text to out as the contents of a JSON string
+static void AppendJSONString(const string &text, string *out) {
+  for (unsigned int i = 0; i < text.size(); ++i) {
+    unsigned char c = text[i];
+    if (c == '"' || c == '\\') {
+      out->push_back('\\');
+      out->push_back(c);
+    } else if (c < 0x20) {
+      char escape[8];
+      snprintf(escape, sizeof(escape), "\\u%04x", c);
+      out->append(escape);
+    } else {
+      out->push_back(c);
+    }
+  }
+}
+
+FileOutputJSON::FileOutputJSON(Parameters *params)
+    : Module(params),
+      file_(0) {
   module_description_ = "File output in JSON format";
   module_identifier_ = "json_out";
   module_type_ = "output";
   module_version_ = "$Id: FileOutputJSON.cc 51 2010-03-30 22:06:24Z tomwalters $";
   file_suffix_ = parameters_->DefaultString("file_suffix", ".json");
+  // Output is written to disk in blocks of this size, optionally from a
+  // separate thread so that processing doesn't wait for the disk
+  int buffer_size_kb = parameters_->DefaultInt("json_out.buffer_size_kb", 64);
+  file_.SetBufferSize(buffer_size_kb * 1024);
+  file_.SetBackgroundWrite(parameters_->DefaultBool(
+      "json_out.background_write", false));
+  // "json" for a single document per input file, or "ndjson" for one line
+  // per frame
+  string format = parameters_->DefaultString("json_out.format", "json");
+  line_delimited_ = (format.compare("ndjson") == 0);
+  if (!line_delimited_ && format.compare("json") != 0) {
+    LOG_ERROR(_T("Unknown JSON output format '%s'. Using 'json'."),
+              format.c_str());
+  }
+  // Stream the frames of every input file to stdout
+  to_stdout_ = parameters_->DefaultBool("json_out.to_stdout", false);
+  if (to_stdout_ && !line_delimited_) {
+    LOG_ERROR(_T("JSON output can only go to stdout in the 'ndjson' "
+                 "format."));
+    to_stdout_ = false;
+  }
 
   header_written_ = false;
   frame_period_ms_ = 0.0f;
 }
 
 FileOutputJSON::~FileOutputJSON() {
-  if (file_handle_)
+  if (file_.is_open())
     CloseFile();
 }
 
 bool FileOutputJSON::OpenFile(string &filename) {
-  file_handle_.open(filename.c_str());
+  if (to_stdout_) {
+    if (!file_.is_open() && !file_.OpenStandardOutput()) {
+      LOG_ERROR(_T("Couldn't write to stdout."));
+      return false;
+    }
+  } else if (!file_.Open(filename)) {
+    LOG_ERROR(_T("Couldn't open output file '%s' for writing."),
+              filename.c_str());
+    return false;
+  }
+  text_.str("");
   
   frame_count_ = 0;
   frame_period_ms_ = 0.0;
@@ -81,22 +255,30 @@ bool FileOutputJSON::InitializeInternal(const SignalBank &input) {
   buffer_length_ = input.buffer_length();  
   sample_rate_ = input.sample_rate();
   ResetInternal();
-  if (file_handle_ == NULL) {
+  if (!file_.is_open()) {
     LOG_ERROR(_T("Couldn't initialize file output."));
     return false;
   }
+  // The first file was opened before the module counted as initialized
+  if (!header_written_) {
+    WriteHeader();
+  }
   return true;
 }
 
 void FileOutputJSON::ResetInternal() {
-  if (file_handle_ != NULL && !header_written_) {
+  if (file_.is_open() && !header_written_) {
     WriteHeader();
   }
-  if (file_handle_ != NULL)
+  // stdout stays open from one input file to the next
+  if (file_.is_open() && !to_stdout_)
     CloseFile();
     
   string out_filename;
   out_filename = global_parameters_->GetString("output_filename_base") + file_suffix_;
+  file_id_.clear();
+  AppendJSONString(global_parameters_->GetString("output_filename_base"),
+                   &file_id_);
   OpenFile(out_filename);
 }
 
@@ -104,21 +286,34 @@ void FileOutputJSON::WriteHeader() {
   if (header_written_)
     return;
 
+  // Every line of line-delimited JSON stands alone
+  if (line_delimited_) {
+    header_written_ = true;
+    return;
+  }
+
   uint32_t channels_out = channel_count_;
   uint32_t samples_out = buffer_length_;
   float sample_rate = sample_rate_;
 
-  file_handle_ << std::setprecision(3);
-  file_handle_ << "{" << std::endl;
-  file_handle_ << "\"channels\" : " << channels_out << "," << std::endl;
-  file_handle_ << "\"samples\" : " << sizeof(samples_out) << "," << std::endl;
-  file_handle_ << "\"sample_rate\" : " << sizeof(sample_rate) << "," << std::endl;
+  text_ << std::setprecision(3);
+  text_ << "{" << std::endl;
+  text_ << "\"channels\" : " << channels_out << "," << std::endl;
+  text_ << "\"samples\" : " << sizeof(samples_out) << "," << std::endl;
+  text_ << "\"sample_rate\" : " << sizeof(sample_rate) << "," << std::endl;
+  WriteText();
 
   header_written_ = true;
 }
 
+void FileOutputJSON::WriteText() {
+  const string &text = text_.str();
+  file_.Write(text.data(), text.size());
+  text_.str("");
+}
+
 void FileOutputJSON::Process(const SignalBank &input) {
-  if (file_handle_ == NULL) {
+  if (!file_.is_open()) {
     LOG_ERROR(_T("Couldn't process file output. No file is open."
                  "Please call FileOutputJSON::OpenFile first"));
     return;
@@ -130,42 +325,96 @@ void FileOutputJSON::Process(const SignalBank &input) {
                  "FileOutputJSON::Process()"));
     return;
   }
+
+  if (line_delimited_) {
+    WriteFrameLine(input);
+    frame_count_++;
+    return;
+  }
+
   float s;
 
   for (int ch = 0; ch < input.channel_count(); ch++) {
-    file_handle_ << "\"channel\" : [";
+    text_ << "\"channel\" : [";
     for (int i = 0; i < input.buffer_length(); i++) {
       s = input.sample(ch, i);
-      file_handle_ << s;
+      text_ << s;
       if (i < input.buffer_length() - 1) {
-        file_handle_ << ",";
+        text_ << ",";
       }
     }
-    file_handle_ << "]" << std::endl;
+    text_ << "]" << std::endl;
     if (ch < input.channel_count() - 1) {
-      file_handle_ << ",";
+      text_ << ",";
     }
   }
+  WriteText();
 
   frame_count_++;
 
 }
 
+void FileOutputJSON::WriteFrameLine(const SignalBank &input) {
+  char number[32];
+  line_.clear();
+  line_.append("{\"file\":\"");
+  line_.append(file_id_);
+  snprintf(number, sizeof(number), "\",\"frame\":%d", frame_count_);
+  line_.append(number);
+  snprintf(number, sizeof(number), ",\"start_time\":%d",
+           input.start_time());
+  line_.append(number);
+  snprintf(number, sizeof(number), ",\"pitch_index\":%d",
+           input.pitch_index());
+  line_.append(number);
+  line_.append(",\"sample_rate\":");
+  line_.append(number, FormatFloat(input.sample_rate(), number));
+  snprintf(number, sizeof(number), ",\"channels\":%d,\"samples\":%d",
+           input.channel_count(), input.buffer_length());
+  line_.append(number);
+  line_.append(",\"data\":[");
+  for (int ch = 0; ch < input.channel_count(); ++ch) {
+    if (ch > 0) {
+      line_.push_back(',');
+    }
+    line_.push_back('[');
+    const vector<float> &signal = input[ch];
+    for (int i = 0; i < input.buffer_length(); ++i) {
+      if (i > 0) {
+        line_.push_back(',');
+      }
+      line_.append(number, FormatFloat(signal[i], number));
+    }
+    line_.push_back(']');
+  }
+  line_.append("]}\n");
+  file_.Write(line_.data(), line_.size());
+  // Pass each frame on straight away to whatever is reading the stream
+  if (to_stdout_) {
+    file_.Flush();
+  }
+}
+
 bool FileOutputJSON::CloseFile() {
-  if (file_handle_ == NULL)
+  if (!file_.is_open())
     return false;
 
-  uint32_t frame_count = frame_count_;
-  float sample_period_out = frame_period_ms_;
-
-  file_handle_ << "\"frame_count\" : " << sizeof(frame_count) << std::endl;
-  file_handle_ << "\"samples\" : " << sizeof(sample_period_out) << std::endl;
-  file_handle_ << "}" << std::endl;
+  if (!line_delimited_) {
+    uint32_t frame_count = frame_count_;
+    float sample_period_out = frame_period_ms_;
 
+    text_ << "\"frame_count\" : " << sizeof(frame_count) << std::endl;
+    text_ << "\"samples\" : " << sizeof(sample_period_out) << std::endl;
+    text_ << "}" << std::endl;
+    WriteText();
+  }
 
-  file_handle_.close();
+  bool ok = file_.Close();
+  if (!ok) {
+    LOG_ERROR(_T("Error writing JSON output file."));
+  }
   header_written_ = false;
-  return true;
+  return ok;
 }
 }  // namespace aimc
 
@@ -29,15 +29,35 @@
 #define AIMC_MODULES_OUTPUT_JSON_H_
 
 #include <string>
-#include <iostream>
-#include <fstream>
+#include <sstream>
 
 // using namespace std;
 
+#include "Support/BufferedFileWriter.h"
 #include "Support/Module.h"
 #include "Support/SignalBank.h"
 
 namespace aimc {
+/*! \brief Write the shortest decimal representation of value which reads
+ *  back as the same float, as a JSON number, to out, which must have room
+ *  for 32 characters. Infinity and NaN are written as null.
+ *  \return The number of characters written
+ */
+int FormatFloat(float value, char *out);
+
+/*! \brief Writes frames as JSON, either as a single document per input
+ *  file, or with json_out.format set to "ndjson", as one compact object
+ *  per frame, on a line of its own:
+ *  {"file":"...","frame":0,"start_time":0,"pitch_index":-1,
+ *   "sample_rate":16000,"channels":2,"samples":3,"data":[[...],[...]]}
+ *  pitch_index is the pitch lag found by the SSI, in samples, or -1 if the
+ *  pitch of the frame isn't known.
+ *
+ * With json_out.to_stdout, the lines for all input files go to stdout as
+ * each frame is processed, for another process to consume as a stream.
+ * Log messages share stdout, so readers should skip lines which don't
+ * start with '{'.
+ */
 class FileOutputJSON : public Module {
  public:
   /*! \brief Create a new file output for an JSON format file.
@@ -61,15 +81,31 @@ class FileOutputJSON : public Module {
 
   void WriteHeader();
 
+  /*! \brief Write a frame as a single line of line-delimited JSON
+   */
+  void WriteFrameLine(const SignalBank &input);
+
+  /*! \brief Pass the text formatted so far to the output file
+   */
+  void WriteText();
+
   /*! \brief Whether initialization is done or not
    */
   bool header_written_;
 
-  /*! \brief Internal pointer to the output file
+  /*! \brief The output file, and the text waiting to be written to it
+   */
+  BufferedFileWriter file_;
+  std::ostringstream text_;
+
+  /*! \brief Buffer in which each line of line-delimited JSON is formatted,
+   *  reused from frame to frame
+   */
+  string line_;
+
+  /*! \brief output_filename_base of the current input, as a JSON string
    */
-  // FILE *file_handle_;
-  // FILE *strobes_file_handle_;
-  std::ofstream file_handle_;
+  string file_id_;
 
   /*! \brief Count of the number of samples in the file, written on close
    */
@@ -80,6 +116,8 @@ class FileOutputJSON : public Module {
   float sample_rate_;  
   float frame_period_ms_;
   string file_suffix_;
+  bool line_delimited_;
+  bool to_stdout_;
   bool dump_strobes_;
   string strobes_file_suffix_;
 };
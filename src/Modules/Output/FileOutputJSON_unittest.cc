@@ -0,0 +1,106 @@
+// Copyright 2026, agent
+//
+// AIM-C: A C++ implementation of the Auditory Image Model
+// http://www.acousticscale.org/AIMC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*!
+ * \author agent <agent@local>
+ * \date created 2026/10/19
+ * \version \$Id$
+ */
+
+#include <float.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <limits>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "Modules/Output/FileOutputJSON.h"
+
+namespace aimc {
+using std::numeric_limits;
+using std::string;
+
+static string Format(float value) {
+  char text[32];
+  int length = FormatFloat(value, text);
+  return string(text, length);
+}
+
+static float FloatFromBits(uint32_t bits) {
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+// Check that the text of value is a single number which reads back as the
+// same float
+static void ExpectRoundTrip(float value) {
+  string text = Format(value);
+  const char *start = text.c_str();
+  char *end;
+  float read_back = static_cast<float>(strtod(start, &end));
+  EXPECT_EQ(text.size(), static_cast<size_t>(end - start)) << text;
+  EXPECT_EQ(value, read_back) << text;
+}
+
+TEST(FileOutputJSONTest, FormatsKnownValues) {
+  EXPECT_EQ("0.1", Format(0.1f));
+  EXPECT_EQ("0.3", Format(0.3f));
+  EXPECT_EQ("0.33333334", Format(1.0f / 3.0f));
+  EXPECT_EQ("1.5", Format(1.5f));
+  EXPECT_EQ("-2.25", Format(-2.25f));
+  EXPECT_EQ("100", Format(100.0f));
+  EXPECT_EQ("16000", Format(16000.0f));
+  EXPECT_EQ("123456.7", Format(123456.7f));
+  EXPECT_EQ("0.00001", Format(1e-5f));
+}
+
+TEST(FileOutputJSONTest, FormatsSpecialValues) {
+  EXPECT_EQ("0", Format(0.0f));
+  // JSON readers don't all keep the sign of zero, so it's dropped
+  EXPECT_EQ("0", Format(-0.0f));
+  EXPECT_EQ("null", Format(numeric_limits<float>::quiet_NaN()));
+  EXPECT_EQ("null", Format(numeric_limits<float>::infinity()));
+  EXPECT_EQ("null", Format(-numeric_limits<float>::infinity()));
+
+  ExpectRoundTrip(FLT_MIN);
+  ExpectRoundTrip(-FLT_MIN);
+  ExpectRoundTrip(FLT_MAX);
+  ExpectRoundTrip(-FLT_MAX);
+  // Smallest and largest denormals
+  ExpectRoundTrip(FloatFromBits(0x00000001));
+  ExpectRoundTrip(FloatFromBits(0x007fffff));
+  ExpectRoundTrip(FloatFromBits(0x80000001));
+}
+
+TEST(FileOutputJSONTest, RandomFloatsRoundTrip) {
+  const int kTrials = 200000;
+  // Linear congruential generator, so that failures are reproducible
+  uint32_t state = 12345;
+  for (int trial = 0; trial < kTrials; ++trial) {
+    state = state * 1664525u + 1013904223u;
+    float value = FloatFromBits(state);
+    if (value != value || value > FLT_MAX || value < -FLT_MAX) {
+      continue;
+    }
+    ExpectRoundTrip(value);
+  }
+}
+}  // namespace aimc
@@ -0,0 +1,325 @@
+// Copyright 2026, agent
+//
+// AIM-C: A C++ implementation of the Auditory Image Model
+// http://www.acousticscale.org/AIMC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*!
+ * \author agent <agent@local>
+ * \date created 2026/10/19
+ * \version \$Id$
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "Modules/Output/FileOutputNumpy.h"
+
+namespace aimc {
+// Size of the header of the .npy file of frames. It's big enough for any
+// frame count, so the header can be filled in when the file is closed
+// without moving the data.
+static const size_t kFramesHeaderSize = 128;
+
+string NpyType(char kind, int size) {
+  const uint16_t kOne = 1;
+  char byte_order = (*reinterpret_cast<const char*>(&kOne) == 1) ? '<' : '>';
+  char type[8];
+  snprintf(type, sizeof(type), "%c%c%d", byte_order, kind, size);
+  return type;
+}
+
+string NpyHeader(const string &type, const string &shape, size_t min_size) {
+  string header("\x93NUMPY\x01\x00", 8);
+  string dict = "{'descr': '" + type + "', 'fortran_order': False, "
+                "'shape': " + shape + ", }";
+  // Magic string, version, header length, dictionary and newline
+  size_t size = header.size() + 2 + dict.size() + 1;
+  if (size < min_size) {
+    size = min_size;
+  }
+  size = (size + 63) / 64 * 64;
+  dict.append(size - header.size() - 2 - dict.size() - 1, ' ');
+  dict.push_back('\n');
+  header.push_back(dict.size() & 0xff);
+  header.push_back((dict.size() >> 8) & 0xff);
+  return header + dict;
+}
+
+static void AppendUint16(uint16_t value, string *out) {
+  out->push_back(value & 0xff);
+  out->push_back((value >> 8) & 0xff);
+}
+
+static void AppendUint32(uint32_t value, string *out) {
+  AppendUint16(value & 0xffff, out);
+  AppendUint16(value >> 16, out);
+}
+
+uint32_t Crc32(const char *data, size_t size, uint32_t crc) {
+  static uint32_t table[256];
+  static bool table_ready = false;
+  if (!table_ready) {
+    for (uint32_t i = 0; i < 256; ++i) {
+      uint32_t c = i;
+      for (int k = 0; k < 8; ++k) {
+        c = (c & 1) ? (0xedb88320 ^ (c >> 1)) : (c >> 1);
+      }
+      table[i] = c;
+    }
+    table_ready = true;
+  }
+  crc = ~crc;
+  for (size_t i = 0; i < size; ++i) {
+    crc = table[(crc ^ static_cast<unsigned char>(data[i])) & 0xff]
+          ^ (crc >> 8);
+  }
+  return ~crc;
+}
+
+NpzBuilder::NpzBuilder() : count_(0) {
+}
+
+void NpzBuilder::Add(const string &name, const string &type,
+                     const string &shape, const void *data, size_t size) {
+  string member_name = name + ".npy";
+  string header = NpyHeader(type, shape, 0);
+  uint32_t crc = Crc32(header.data(), header.size(), 0);
+  if (size > 0) {
+    crc = Crc32(static_cast<const char*>(data), size, crc);
+  }
+  uint32_t member_size = header.size() + size;
+  uint32_t offset = contents_.size();
+
+  // Local file header
+  AppendUint32(0x04034b50, &contents_);
+  AppendFileFields(member_name, crc, member_size, &contents_);
+  contents_.append(member_name);
+  contents_.append(header);
+  if (size > 0) {
+    contents_.append(static_cast<const char*>(data), size);
+  }
+
+  // Central directory entry
+  AppendUint32(0x02014b50, &directory_);
+  AppendUint16(20, &directory_);  // Version made by
+  AppendFileFields(member_name, crc, member_size, &directory_);
+  AppendUint16(0, &directory_);  // Comment length
+  AppendUint16(0, &directory_);  // Disk number
+  AppendUint16(0, &directory_);  // Internal attributes
+  AppendUint32(0, &directory_);  // External attributes
+  AppendUint32(offset, &directory_);
+  directory_.append(member_name);
+  ++count_;
+}
+
+string NpzBuilder::Finish() const {
+  string end;
+  AppendUint32(0x06054b50, &end);
+  AppendUint16(0, &end);  // Disk number
+  AppendUint16(0, &end);  // Disk with the central directory
+  AppendUint16(count_, &end);
+  AppendUint16(count_, &end);
+  AppendUint32(directory_.size(), &end);
+  AppendUint32(contents_.size(), &end);
+  AppendUint16(0, &end);  // Comment length
+  return contents_ + directory_ + end;
+}
+
+void NpzBuilder::AppendFileFields(const string &name, uint32_t crc,
+                                  uint32_t size, string *out) {
+  AppendUint16(20, out);  // Version needed to extract
+  AppendUint16(0, out);  // Flags
+  AppendUint16(0, out);  // Stored, without compression
+  AppendUint16(0, out);  // Modification time
+  AppendUint16(0x21, out);  // Modification date, 1980/01/01
+  AppendUint32(crc, out);
+  AppendUint32(size, out);  // Compressed size
+  AppendUint32(size, out);  // Uncompressed size
+  AppendUint16(name.size(), out);
+  AppendUint16(0, out);  // Extra field length
+}
+
+FileOutputNumpy::FileOutputNumpy(Parameters *params)
+    : Module(params),
+      file_(0) {
+  module_description_ = "File output in NumPy .npy format";
+  module_identifier_ = "npy_out";
+  module_type_ = "output";
+  module_version_ = "$Id$";
+
+  file_suffix_ = parameters_->DefaultString("npy_out.file_suffix", ".npy");
+  // Also write the centre frequencies, frame start times, pitches and
+  // strobes to an .npz file for each input file
+  write_npz_ = parameters_->DefaultBool("npy_out.write_npz", false);
+  npz_suffix_ = parameters_->DefaultString("npy_out.npz_suffix", ".npz");
+  int buffer_size_kb = parameters_->DefaultInt("npy_out.buffer_size_kb", 64);
+  file_.SetBufferSize(buffer_size_kb * 1024);
+  file_.SetBackgroundWrite(parameters_->DefaultBool(
+      "npy_out.background_write", false));
+  frame_count_ = 0;
+  channel_count_ = 0;
+  buffer_length_ = 0;
+  sample_rate_ = 0.0f;
+}
+
+FileOutputNumpy::~FileOutputNumpy() {
+  if (file_.is_open())
+    CloseFile();
+}
+
+bool FileOutputNumpy::InitializeInternal(const SignalBank &input) {
+  channel_count_ = input.channel_count();
+  buffer_length_ = input.buffer_length();
+  sample_rate_ = input.sample_rate();
+  centre_frequencies_.resize(channel_count_);
+  for (int ch = 0; ch < channel_count_; ++ch) {
+    centre_frequencies_[ch] = input.centre_frequency(ch);
+  }
+
+  if (file_.is_open())
+    CloseFile();
+  string base = global_parameters_->GetString("output_filename_base");
+  if (!OpenFile(base + file_suffix_)) {
+    LOG_ERROR(_T("Couldn't initialize file output."));
+    return false;
+  }
+  npz_filename_ = base + npz_suffix_;
+  return true;
+}
+
+void FileOutputNumpy::ResetInternal() {
+  if (file_.is_open())
+    CloseFile();
+  // A Reset() with no output filename comes after the last input file
+  string base = global_parameters_->GetString("output_filename_base");
+  if (base.empty()) {
+    return;
+  }
+  OpenFile(base + file_suffix_);
+  npz_filename_ = base + npz_suffix_;
+}
+
+bool FileOutputNumpy::OpenFile(const string &filename) {
+  if (!file_.Open(filename)) {
+    LOG_ERROR(_T("Couldn't open output file '%s' for writing."),
+              filename.c_str());
+    return false;
+  }
+  frame_count_ = 0;
+  start_times_.clear();
+  pitch_indices_.clear();
+  strobe_rows_.assign(1, 0);
+  strobe_values_.clear();
+  string header = MakeHeader();
+  file_.Write(header.data(), header.size());
+  return true;
+}
+
+string FileOutputNumpy::MakeHeader() const {
+  char shape[64];
+  snprintf(shape, sizeof(shape), "(%d, %d, %d)", frame_count_,
+           channel_count_, buffer_length_);
+  return NpyHeader(NpyType('f', sizeof(float)), shape, kFramesHeaderSize);
+}
+
+void FileOutputNumpy::Process(const SignalBank &input) {
+  if (!file_.is_open()) {
+    LOG_ERROR(_T("Couldn't process file output. No file is open."));
+    return;
+  }
+
+  // The array has a single frame size, so a buffer of any other length
+  // (such as the short final buffer of an input file) can't be written
+  if (input.buffer_length() != buffer_length_
+      || input.channel_count() != channel_count_) {
+    return;
+  }
+
+  size_t channel_size = buffer_length_ * sizeof(float);
+  for (int ch = 0; ch < channel_count_; ++ch) {
+    file_.Write(&input[ch][0], channel_size);
+  }
+  ++frame_count_;
+
+  if (write_npz_) {
+    start_times_.push_back(input.start_time());
+    pitch_indices_.push_back(input.pitch_index());
+    for (int ch = 0; ch < channel_count_; ++ch) {
+      const vector<int> &strobes = input.get_strobes(ch);
+      strobe_values_.insert(strobe_values_.end(), strobes.begin(),
+                            strobes.end());
+      strobe_rows_.push_back(strobe_values_.size());
+    }
+  }
+}
+
+bool FileOutputNumpy::CloseFile() {
+  if (!file_.is_open())
+    return false;
+
+  string header = MakeHeader();
+  file_.Overwrite(0, header.data(), header.size());
+  bool ok = file_.Close();
+  if (!ok) {
+    LOG_ERROR(_T("Error writing NumPy output file."));
+  }
+  if (write_npz_ && !WriteNpz(npz_filename_)) {
+    ok = false;
+  }
+  return ok;
+}
+
+bool FileOutputNumpy::WriteNpz(const string &filename) {
+  NpzBuilder npz;
+  char shape[64];
+  snprintf(shape, sizeof(shape), "(%d,)", channel_count_);
+  npz.Add("centre_frequencies", NpyType('f', sizeof(float)), shape,
+          centre_frequencies_.empty() ? NULL : &centre_frequencies_[0],
+          centre_frequencies_.size() * sizeof(float));
+  snprintf(shape, sizeof(shape), "(%d,)", frame_count_);
+  npz.Add("start_times", NpyType('i', sizeof(int64_t)), shape,
+          start_times_.empty() ? NULL : &start_times_[0],
+          start_times_.size() * sizeof(int64_t));
+  npz.Add("pitch_indices", NpyType('i', sizeof(int32_t)), shape,
+          pitch_indices_.empty() ? NULL : &pitch_indices_[0],
+          pitch_indices_.size() * sizeof(int32_t));
+  npz.Add("sample_rate", NpyType('f', sizeof(float)), "()", &sample_rate_,
+          sizeof(sample_rate_));
+  snprintf(shape, sizeof(shape), "(%d,)",
+           static_cast<int>(strobe_rows_.size()));
+  npz.Add("strobe_rows", NpyType('u', sizeof(uint64_t)), shape,
+          &strobe_rows_[0], strobe_rows_.size() * sizeof(uint64_t));
+  snprintf(shape, sizeof(shape), "(%d,)",
+           static_cast<int>(strobe_values_.size()));
+  npz.Add("strobe_values", NpyType('i', sizeof(int32_t)), shape,
+          strobe_values_.empty() ? NULL : &strobe_values_[0],
+          strobe_values_.size() * sizeof(int32_t));
+  string contents = npz.Finish();
+
+  FILE *file = fopen(filename.c_str(), "wb");
+  if (file == NULL) {
+    LOG_ERROR(_T("Couldn't open output file '%s' for writing."),
+              filename.c_str());
+    return false;
+  }
+  bool ok = (fwrite(contents.data(), 1, contents.size(), file)
+             == contents.size());
+  ok = (fclose(file) == 0) && ok;
+  if (!ok) {
+    LOG_ERROR(_T("Error writing NumPy output file '%s'."), filename.c_str());
+  }
+  return ok;
+}
+}  // namespace aimc
@@ -0,0 +1,144 @@
+// Copyright 2026, agent
+//
+// AIM-C: A C++ implementation of the Auditory Image Model
+// http://www.acousticscale.org/AIMC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*! \file
+ *  \brief File output in NumPy's .npy format
+ */
+
+/*!
+ * \author agent <agent@local>
+ * \date created 2026/10/19
+ * \version \$Id$
+ */
+
+#ifndef AIMC_MODULES_OUTPUT_NUMPY_H_
+#define AIMC_MODULES_OUTPUT_NUMPY_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "Support/BufferedFileWriter.h"
+#include "Support/Module.h"
+#include "Support/SignalBank.h"
+
+namespace aimc {
+using std::string;
+using std::vector;
+
+/*! \brief Return the .npy type string for values of the given kind ('f',
+ *  'i' or 'u') and size, in the byte order of this machine
+ */
+string NpyType(char kind, int size);
+
+/*! \brief Return a version 1.0 .npy header for an array with the given type
+ *  and shape, such as "(10, 3)". The header is padded with spaces to a
+ *  multiple of 64 bytes, and to at least min_size bytes.
+ */
+string NpyHeader(const string &type, const string &shape, size_t min_size);
+
+/*! \brief Return the CRC-32, as used by zip files, of data, continuing
+ *  from the CRC-32 crc of the data before it
+ */
+uint32_t Crc32(const char *data, size_t size, uint32_t crc);
+
+/*! \brief Builds an uncompressed zip file in memory, which is what
+ *  numpy.savez() writes and numpy.load() reads as a .npz file
+ */
+class NpzBuilder {
+ public:
+  NpzBuilder();
+
+  /*! \brief Add the array name.npy, of the given type and shape
+   */
+  void Add(const string &name, const string &type, const string &shape,
+           const void *data, size_t size);
+
+  /*! \brief Return the complete zip file
+   */
+  string Finish() const;
+
+ private:
+  /*! \brief Append the fields common to the local header and the central
+   *  directory entry
+   */
+  static void AppendFileFields(const string &name, uint32_t crc,
+                               uint32_t size, string *out);
+
+  string contents_;
+  string directory_;
+  int count_;
+};
+
+/*! \brief Writes the frames for each input file to a .npy file, as a
+ *  float32 array of shape (frames, channels, samples), which
+ *  numpy.load(filename, mmap_mode='r') can open without parsing.
+ *
+ * Optionally, an .npz file is written alongside it, holding the arrays
+ * centre_frequencies, start_times (in samples), pitch_indices (the pitch
+ * lag of each frame found by the SSI, in samples, or -1 if it isn't known),
+ * sample_rate, and the strobes in compressed sparse row form as strobe_rows
+ * and strobe_values.
+ * The strobes of channel c of frame f are strobe_values[strobe_rows[i]] up
+ * to strobe_values[strobe_rows[i + 1]], where i = f * channels + c.
+ */
+class FileOutputNumpy : public Module {
+ public:
+  explicit FileOutputNumpy(Parameters *pParam);
+  virtual ~FileOutputNumpy();
+  virtual void Process(const SignalBank &input);
+
+ private:
+  virtual bool InitializeInternal(const SignalBank &input);
+  virtual void ResetInternal();
+
+  bool OpenFile(const string &filename);
+
+  /*! \brief Fill in the number of frames in the header, and write the .npz
+   *  file if there is one
+   */
+  bool CloseFile();
+
+  /*! \brief Return the .npy header for the frames written so far. It is
+   *  always the same size, so that it can be rewritten in place.
+   */
+  string MakeHeader() const;
+  bool WriteNpz(const string &filename);
+
+  BufferedFileWriter file_;
+  string npz_filename_;
+  int frame_count_;
+
+  /*! \brief Contents of the .npz file, kept until the .npy file is closed
+   */
+  vector<float> centre_frequencies_;
+  vector<int64_t> start_times_;
+  vector<int32_t> pitch_indices_;
+  vector<uint64_t> strobe_rows_;
+  vector<int32_t> strobe_values_;
+
+  int channel_count_;
+  int buffer_length_;
+  float sample_rate_;
+  string file_suffix_;
+  bool write_npz_;
+  string npz_suffix_;
+};
+}  // namespace aimc
+
+#endif  // AIMC_MODULES_OUTPUT_NUMPY_H_
@@ -0,0 +1,198 @@
+// Copyright 2026, agent
+//
+// AIM-C: A C++ implementation of the Auditory Image Model
+// http://www.acousticscale.org/AIMC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*!
+ * \author agent <agent@local>
+ * \date created 2026/10/19
+ * \version \$Id$
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "Modules/Output/FileOutputNumpy.h"
+#include "Support/Parameters.h"
+#include "Support/SignalBank.h"
+
+namespace aimc {
+using std::string;
+
+static const char kFilenameBase[] = "FileOutputNumpy_unittest";
+static const int kChannels = 3;
+static const int kSamples = 4;
+static const int kFrames = 5;
+
+// Size of the zip end of central directory record
+static const size_t kEndSize = 22;
+
+static uint32_t ReadUint(const string &data, size_t offset, int size) {
+  uint32_t value = 0;
+  for (int i = size - 1; i >= 0; --i) {
+    value = (value << 8) | static_cast<unsigned char>(data[offset + i]);
+  }
+  return value;
+}
+
+// Return the contents of a file, or an empty string if it can't be read
+static string ReadFile(const string &filename) {
+  string contents;
+  FILE *file = fopen(filename.c_str(), "rb");
+  if (file == NULL) {
+    return contents;
+  }
+  char buffer[4096];
+  size_t count;
+  while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    contents.append(buffer, count);
+  }
+  fclose(file);
+  return contents;
+}
+
+TEST(FileOutputNumpyTest, Crc32MatchesKnownValue) {
+  const char kCheck[] = "123456789";
+  EXPECT_EQ(0xcbf43926u, Crc32(kCheck, 9, 0));
+  // The CRC can be found a piece at a time
+  EXPECT_EQ(0xcbf43926u, Crc32(kCheck + 4, 5, Crc32(kCheck, 4, 0)));
+  EXPECT_EQ(0u, Crc32(kCheck, 0, 0));
+}
+
+TEST(FileOutputNumpyTest, NpyHeaderIsPaddedTo64Bytes) {
+  const char *kShapes[] = { "()", "(3,)", "(5, 3, 4)",
+                            "(1000000000, 100000, 100000)" };
+  const size_t kMinSizes[] = { 0, 128 };
+  for (int s = 0; s < 4; ++s) {
+    for (int m = 0; m < 2; ++m) {
+      string header = NpyHeader(NpyType('f', sizeof(float)), kShapes[s],
+                                kMinSizes[m]);
+      EXPECT_EQ(0u, header.size() % 64);
+      EXPECT_GE(header.size(), kMinSizes[m]);
+      EXPECT_EQ(0, header.compare(0, 8, string("\x93NUMPY\x01\x00", 8)));
+      // The length field counts the dictionary and its padding
+      EXPECT_EQ(header.size() - 10, ReadUint(header, 8, 2));
+      EXPECT_EQ('\n', header[header.size() - 1]);
+      EXPECT_NE(string::npos,
+                header.find(string("'shape': ") + kShapes[s] + ", }"));
+    }
+  }
+}
+
+TEST(FileOutputNumpyTest, NpzBuilderWritesZipDirectory) {
+  const float kValues[] = { 1.0f, 2.0f, 3.0f };
+  const int32_t kIndices[] = { -1, 7 };
+  NpzBuilder npz;
+  npz.Add("values", NpyType('f', sizeof(float)), "(3,)", kValues,
+          sizeof(kValues));
+  npz.Add("empty", NpyType('i', sizeof(int32_t)), "(0,)", NULL, 0);
+  npz.Add("indices", NpyType('i', sizeof(int32_t)), "(2,)", kIndices,
+          sizeof(kIndices));
+  string zip = npz.Finish();
+  ASSERT_GT(zip.size(), kEndSize);
+
+  size_t end = zip.size() - kEndSize;
+  EXPECT_EQ(0x06054b50u, ReadUint(zip, end, 4));
+  EXPECT_EQ(3u, ReadUint(zip, end + 8, 2));
+  EXPECT_EQ(3u, ReadUint(zip, end + 10, 2));
+  uint32_t directory_size = ReadUint(zip, end + 12, 4);
+  uint32_t directory_offset = ReadUint(zip, end + 16, 4);
+  // The central directory runs from its offset up to the end record
+  EXPECT_EQ(end, directory_offset + directory_size);
+  EXPECT_EQ(0x02014b50u, ReadUint(zip, directory_offset, 4));
+
+  // The first member is stored uncompressed at the start of the file, with
+  // its .npy header followed by the data
+  EXPECT_EQ(0x04034b50u, ReadUint(zip, 0, 4));
+  uint32_t crc = ReadUint(zip, 14, 4);
+  uint32_t size = ReadUint(zip, 18, 4);
+  EXPECT_EQ(size, ReadUint(zip, 22, 4));
+  uint32_t name_length = ReadUint(zip, 26, 2);
+  EXPECT_EQ("values.npy", zip.substr(30, name_length));
+  string header = NpyHeader(NpyType('f', sizeof(float)), "(3,)", 0);
+  EXPECT_EQ(header.size() + sizeof(kValues), size);
+  size_t data_offset = 30 + name_length;
+  EXPECT_EQ(header, zip.substr(data_offset, header.size()));
+  EXPECT_EQ(0, memcmp(zip.data() + data_offset + header.size(), kValues,
+                      sizeof(kValues)));
+  EXPECT_EQ(Crc32(zip.data() + data_offset, size, 0), crc);
+}
+
+TEST(FileOutputNumpyTest, RewritesShapeWhenClosed) {
+  Parameters parameters;
+  parameters.SetBool("npy_out.write_npz", true);
+  Parameters global_parameters;
+  global_parameters.SetString("output_filename_base", kFilenameBase);
+  FileOutputNumpy output(&parameters);
+  SignalBank input;
+  input.Initialize(kChannels, kSamples, 16000.0f);
+  ASSERT_TRUE(output.Initialize(input, &global_parameters));
+  for (int frame = 0; frame < kFrames; ++frame) {
+    for (int ch = 0; ch < kChannels; ++ch) {
+      for (int i = 0; i < kSamples; ++i) {
+        input.set_sample(ch, i, 100.0f * frame + 10.0f * ch + i);
+      }
+    }
+    input.set_start_time(160 * frame);
+    input.set_pitch_index(frame);
+    output.Process(input);
+  }
+  // The last Reset() closes the file
+  global_parameters.SetString("output_filename_base", "");
+  output.Reset();
+
+  string npy_filename = string(kFilenameBase) + ".npy";
+  string npz_filename = string(kFilenameBase) + ".npz";
+  string npy = ReadFile(npy_filename);
+  string npz = ReadFile(npz_filename);
+  remove(npy_filename.c_str());
+  remove(npz_filename.c_str());
+
+  // The header keeps its size when the frame count is filled in, so the
+  // frames stay where they were written
+  string header = NpyHeader(NpyType('f', sizeof(float)), "(5, 3, 4)", 128);
+  ASSERT_EQ(128u, header.size());
+  ASSERT_EQ(header.size() + kFrames * kChannels * kSamples * sizeof(float),
+            npy.size());
+  EXPECT_EQ(header, npy.substr(0, header.size()));
+  const float *frames = reinterpret_cast<const float*>(npy.data()
+                                                       + header.size());
+  for (int frame = 0; frame < kFrames; ++frame) {
+    for (int ch = 0; ch < kChannels; ++ch) {
+      for (int i = 0; i < kSamples; ++i) {
+        EXPECT_EQ(100.0f * frame + 10.0f * ch + i, *frames++);
+      }
+    }
+  }
+
+  ASSERT_GT(npz.size(), kEndSize);
+  EXPECT_EQ(6u, ReadUint(npz, npz.size() - kEndSize + 8, 2));
+  string pitch_header = NpyHeader(NpyType('i', sizeof(int32_t)), "(5,)", 0);
+  size_t pitch_offset = npz.find("pitch_indices.npy" + pitch_header);
+  ASSERT_NE(string::npos, pitch_offset);
+  // Members of the zip file aren't aligned
+  int32_t pitch_indices[kFrames];
+  memcpy(pitch_indices, npz.data() + pitch_offset + strlen("pitch_indices.npy")
+         + pitch_header.size(), sizeof(pitch_indices));
+  for (int frame = 0; frame < kFrames; ++frame) {
+    EXPECT_EQ(frame, pitch_indices[frame]);
+  }
+}
+}  // namespace aimc
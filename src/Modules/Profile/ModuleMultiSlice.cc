@@ -0,0 +1,287 @@
+// Copyright 2026, agent
+//
+// AIM-C: A C++ implementation of the Auditory Image Model
+// http://www.acousticscale.org/AIMC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*!
+ * \author agent <agent@local>
+ * \date created 2026/10/19
+ * \version \$Id$
+ */
+
+#include <stdlib.h>
+
+#include "Modules/Profile/ModuleMultiSlice.h"
+
+namespace aimc {
+// Sum of n values. Four independent partial sums let the compiler use SIMD
+// lanes (and avoid a serial dependency on a single accumulator).
+static inline float SumRange(const float *values, int n) {
+  float sum0 = 0.0f;
+  float sum1 = 0.0f;
+  float sum2 = 0.0f;
+  float sum3 = 0.0f;
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    sum0 += values[i];
+    sum1 += values[i + 1];
+    sum2 += values[i + 2];
+    sum3 += values[i + 3];
+  }
+  for (; i < n; ++i) {
+    sum0 += values[i];
+  }
+  return (sum0 + sum1) + (sum2 + sum3);
+}
+
+ModuleMultiSlice::ModuleMultiSlice(Parameters *params) : Module(params) {
+  module_description_ = "Several temporal and spectral slices of a 2D image";
+  module_identifier_ = "multi_slice";
+  module_type_ = "profile";
+  module_version_ = "$Id$";
+
+  // A comma-separated list of slices, each of the form
+  //   <temporal|spectral>:all[:normalize]
+  // or
+  //   <temporal|spectral>:<lower_index>:<upper_index>[:normalize]
+  // with the same meaning as the slice.* parameters of ModuleSlice.
+  slices_string_ = parameters_->DefaultString("multi_slice.slices",
+                                              "spectral:all");
+}
+
+ModuleMultiSlice::~ModuleMultiSlice() {
+}
+
+bool ModuleMultiSlice::ParseSlices() {
+  slices_.clear();
+  size_t start = 0;
+  while (start <= slices_string_.size()) {
+    size_t end = slices_string_.find(',', start);
+    if (end == string::npos) {
+      end = slices_string_.size();
+    }
+    string spec_string = slices_string_.substr(start, end - start);
+    start = end + 1;
+
+    vector<string> fields;
+    size_t field_start = 0;
+    while (field_start <= spec_string.size()) {
+      size_t field_end = spec_string.find(':', field_start);
+      if (field_end == string::npos) {
+        field_end = spec_string.size();
+      }
+      fields.push_back(spec_string.substr(field_start,
+                                          field_end - field_start));
+      field_start = field_end + 1;
+    }
+
+    SliceSpec spec;
+    spec.take_all = false;
+    spec.requested_lower_limit = 0;
+    spec.requested_upper_limit = 0;
+    spec.normalize = false;
+    unsigned int field = 0;
+    if (fields[field].compare("temporal") == 0) {
+      spec.temporal = true;
+    } else if (fields[field].compare("spectral") == 0) {
+      spec.temporal = false;
+    } else {
+      LOG_ERROR(_T("Unknown slice type '%s' in multi_slice.slices"),
+                fields[field].c_str());
+      return false;
+    }
+    ++field;
+    if (field < fields.size() && fields[field].compare("all") == 0) {
+      spec.take_all = true;
+      ++field;
+    } else if (field + 1 < fields.size()) {
+      spec.requested_lower_limit = atoi(fields[field].c_str());
+      spec.requested_upper_limit = atoi(fields[field + 1].c_str());
+      field += 2;
+    } else {
+      LOG_ERROR(_T("Slice '%s' in multi_slice.slices needs 'all' or a lower "
+                   "and upper index"), spec_string.c_str());
+      return false;
+    }
+    if (field < fields.size() && fields[field].compare("normalize") == 0) {
+      spec.normalize = true;
+      ++field;
+    }
+    if (field != fields.size()) {
+      LOG_ERROR(_T("Unexpected fields in slice '%s' in multi_slice.slices"),
+                spec_string.c_str());
+      return false;
+    }
+    slices_.push_back(spec);
+  }
+  return true;
+}
+
+bool ModuleMultiSlice::InitializeInternal(const SignalBank &input) {
+  // Copy the parameters of the input signal bank into internal variables, so
+  // that they can be checked later.
+  sample_rate_ = input.sample_rate();
+  buffer_length_ = input.buffer_length();
+  channel_count_ = input.channel_count();
+
+  if (!ParseSlices()) {
+    return false;
+  }
+  LayoutSlices();
+
+  if (all_temporal_) {
+    output_.Initialize(slices_.size(), buffer_length_, sample_rate_);
+  } else {
+    output_.Initialize(output_length_, 1, sample_rate_);
+    // Each value of a spectral slice belongs to an input channel
+    for (unsigned int s = 0; s < slices_.size(); ++s) {
+      if (!slices_[s].temporal) {
+        for (int ch = 0; ch < channel_count_; ++ch) {
+          output_.set_centre_frequency(slices_[s].output_offset + ch,
+                                       input.centre_frequency(ch));
+        }
+      }
+    }
+  }
+  return true;
+}
+
+void ModuleMultiSlice::LayoutSlices() {
+  // Bounds-check each slice in the same way as ModuleSlice, and lay the
+  // slices out one after another in the output
+  all_temporal_ = true;
+  any_temporal_ = false;
+  output_length_ = 0;
+  for (unsigned int s = 0; s < slices_.size(); ++s) {
+    SliceSpec &spec = slices_[s];
+    int extent = spec.temporal ? channel_count_ : buffer_length_;
+    spec.lower_limit = spec.requested_lower_limit;
+    spec.upper_limit = spec.requested_upper_limit;
+    if (spec.lower_limit < 0 || spec.take_all) {
+      spec.lower_limit = 0;
+    }
+    if (spec.upper_limit < 0) {
+      spec.upper_limit = 0;
+    }
+    if (spec.upper_limit > extent || spec.take_all) {
+      spec.upper_limit = extent;
+    }
+    if (spec.lower_limit > extent) {
+      spec.lower_limit = extent;
+    }
+    spec.slice_length = spec.upper_limit - spec.lower_limit;
+    if (spec.slice_length < 1) {
+      spec.slice_length = 1;
+    }
+    spec.output_offset = output_length_;
+    if (spec.temporal) {
+      output_length_ += buffer_length_;
+      any_temporal_ = true;
+    } else {
+      output_length_ += channel_count_;
+      all_temporal_ = false;
+    }
+  }
+  values_.resize(output_length_, 0.0f);
+}
+
+void ModuleMultiSlice::ResetInternal() {
+}
+
+void ModuleMultiSlice::Process(const SignalBank &input) {
+  // Check to see if the module has been initialized. If not, processing
+  // should not continue.
+  if (!initialized_) {
+    LOG_ERROR(_T("Module %s not initialized."), module_identifier_.c_str());
+    return;
+  }
+
+  // Check that the input this time has the same channels as the input passed
+  // to Initialize(). The buffer length may vary, unless temporal and
+  // spectral slices are concatenated into a column whose length would then
+  // change.
+  if (channel_count_ != input.channel_count()
+      || (buffer_length_ != input.buffer_length()
+          && any_temporal_ && !all_temporal_)) {
+    LOG_ERROR(_T("Mismatch between input to Initialize() and input to "
+                 "Process() in module %s."), module_identifier_.c_str());
+    return;
+  }
+  if (buffer_length_ != input.buffer_length()) {
+    buffer_length_ = input.buffer_length();
+    LayoutSlices();
+    if (all_temporal_) {
+      output_.SetBufferLength(buffer_length_);
+    }
+  }
+
+  output_.set_start_time(input.start_time());
+  output_.set_pitch_index(input.pitch_index());
+
+  for (unsigned int s = 0; s < slices_.size(); ++s) {
+    if (slices_[s].temporal) {
+      float *slice = &values_[slices_[s].output_offset];
+      for (int i = 0; i < buffer_length_; ++i) {
+        slice[i] = 0.0f;
+      }
+    }
+  }
+
+  // A single pass over the image: each channel is read once while it is in
+  // cache, and contributes to every slice which covers it
+  for (int ch = 0; ch < channel_count_; ++ch) {
+    const float *row = &input[ch][0];
+    for (unsigned int s = 0; s < slices_.size(); ++s) {
+      const SliceSpec &spec = slices_[s];
+      if (spec.temporal) {
+        if (ch >= spec.lower_limit && ch < spec.upper_limit) {
+          float *slice = &values_[spec.output_offset];
+          for (int i = 0; i < buffer_length_; ++i) {
+            slice[i] += row[i];
+          }
+        }
+      } else {
+        values_[spec.output_offset + ch] = SumRange(
+            row + spec.lower_limit, spec.upper_limit - spec.lower_limit);
+      }
+    }
+  }
+
+  for (unsigned int s = 0; s < slices_.size(); ++s) {
+    const SliceSpec &spec = slices_[s];
+    if (spec.normalize) {
+      int length = spec.temporal ? buffer_length_ : channel_count_;
+      float *slice = &values_[spec.output_offset];
+      for (int i = 0; i < length; ++i) {
+        slice[i] /= static_cast<float>(spec.slice_length);
+      }
+    }
+  }
+
+  if (all_temporal_) {
+    for (unsigned int s = 0; s < slices_.size(); ++s) {
+      const float *slice = &values_[slices_[s].output_offset];
+      for (int i = 0; i < buffer_length_; ++i) {
+        output_.set_sample(s, i, slice[i]);
+      }
+    }
+  } else {
+    for (int i = 0; i < output_length_; ++i) {
+      output_.set_sample(i, 0, values_[i]);
+    }
+  }
+  PushOutput();
+}
+}  // namespace aimc
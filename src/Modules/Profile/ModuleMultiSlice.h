@@ -0,0 +1,112 @@
+// Copyright 2026, agent
+//
+// AIM-C: A C++ implementation of the Auditory Image Model
+// http://www.acousticscale.org/AIMC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*! \file
+ *  \brief Several temporal and spectral slices of a 2D image, computed in a
+ *  single pass
+ */
+
+/*!
+ * \author agent <agent@local>
+ * \date created 2026/10/19
+ * \version \$Id$
+ */
+
+#ifndef AIMC_MODULES_PROFILE_MULTI_SLICE_H_
+#define AIMC_MODULES_PROFILE_MULTI_SLICE_H_
+
+#include <string>
+#include <vector>
+
+#include "Support/Module.h"
+
+namespace aimc {
+using std::string;
+using std::vector;
+class ModuleMultiSlice : public Module {
+ public:
+  explicit ModuleMultiSlice(Parameters *pParam);
+  virtual ~ModuleMultiSlice();
+
+  /*! \brief Process a buffer
+   */
+  virtual void Process(const SignalBank &input);
+
+ private:
+  /*! \brief Reset the internal state of the module
+   */
+  virtual void ResetInternal();
+
+  /*! \brief Prepare the module
+   *  \param input Input signal
+   *  \param output true on success false on failure
+   */
+  virtual bool InitializeInternal(const SignalBank &input);
+
+  /*! \brief A single slice, as taken by ModuleSlice
+   */
+  struct SliceSpec {
+    bool temporal;
+    bool take_all;
+    /*! \brief Limits as given in multi_slice.slices, and as bounded by the
+     *  current input
+     */
+    int requested_lower_limit;
+    int requested_upper_limit;
+    int lower_limit;
+    int upper_limit;
+    bool normalize;
+    /*! \brief Number of rows or columns summed
+     */
+    int slice_length;
+    /*! \brief Where the slice starts in the output
+     */
+    int output_offset;
+  };
+
+  /*! \brief Parse the list of slice specifications in slices_string_ into
+   *  slices_
+   */
+  bool ParseSlices();
+
+  /*! \brief Bound the limits of each slice to the current input, and lay
+   *  the slices out one after another in values_
+   */
+  void LayoutSlices();
+
+  float sample_rate_;
+  int buffer_length_;
+  int channel_count_;
+
+  string slices_string_;
+  vector<SliceSpec> slices_;
+
+  /*! \brief If all the slices are temporal, each one is output as a channel
+   *  of the output bank. Otherwise the slices are concatenated into a single
+   *  column of features.
+   */
+  bool all_temporal_;
+  bool any_temporal_;
+  int output_length_;
+
+  /*! \brief Slices of the current image, concatenated
+   */
+  vector<float> values_;
+};
+}  // namespace aimc
+
+#endif  // AIMC_MODULES_PROFILE_MULTI_SLICE_H_
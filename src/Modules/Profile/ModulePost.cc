@@ -0,0 +1,288 @@
+// Copyright 2026, agent
+//
+// AIM-C: A C++ implementation of the Auditory Image Model
+// http://www.acousticscale.org/AIMC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*!
+ * \author agent <agent@local>
+ * \date created 2026/10/19
+ * \version \$Id$
+ */
+
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+
+#include "Modules/Profile/ModulePost.h"
+
+namespace aimc {
+// Added to the variance before normalisation, so that values which have
+// not (yet) varied are mapped to zero rather than to NaN
+static const float kVarianceFloor = 1e-12f;
+
+ModulePost::ModulePost(Parameters *params) : Module(params) {
+  module_description_ = "Chain of elementwise operations";
+  module_identifier_ = "post";
+  module_type_ = "profile";
+  module_version_ = "$Id$";
+
+  // A comma-separated list of operations, applied in order to every value
+  // of the input:
+  //   scale_cf            multiply by the channel centre frequency
+  //   scale:<k>           multiply by k
+  //   offset:<k>          add k
+  //   power:<p>           raise to the power p
+  //   log[:<floor>]       natural log, of values no smaller than floor
+  //                       (default FLT_MIN)
+  //   clamp:<min>:<max>   limit to the range [min, max]
+  //   normalize[:<n>]     subtract the running mean and divide by the running
+  //                       standard deviation of each value, over roughly the
+  //                       last n frames (default 100)
+  // For example "scale_cf,power:0.8,log,normalize" replaces a scaler module
+  // and a separate normalisation pass.
+  operations_string_ = parameters_->DefaultString("post.operations",
+                                                  "scale_cf");
+}
+
+ModulePost::~ModulePost() {
+}
+
+bool ModulePost::ParseOperations() {
+  operations_.clear();
+  size_t start = 0;
+  while (start <= operations_string_.size()) {
+    size_t end = operations_string_.find(',', start);
+    if (end == string::npos) {
+      end = operations_string_.size();
+    }
+    string operation_string = operations_string_.substr(start, end - start);
+    start = end + 1;
+
+    vector<string> fields;
+    size_t field_start = 0;
+    while (field_start <= operation_string.size()) {
+      size_t field_end = operation_string.find(':', field_start);
+      if (field_end == string::npos) {
+        field_end = operation_string.size();
+      }
+      fields.push_back(operation_string.substr(field_start,
+                                               field_end - field_start));
+      field_start = field_end + 1;
+    }
+
+    Operation operation;
+    operation.a = 0.0f;
+    operation.b = 0.0f;
+    unsigned int argument_count = 0;
+    unsigned int optional_argument_count = 0;
+    const string &name = fields[0];
+    if (name.compare("scale_cf") == 0) {
+      operation.type = kScaleByCF;
+    } else if (name.compare("scale") == 0) {
+      operation.type = kScale;
+      argument_count = 1;
+    } else if (name.compare("offset") == 0) {
+      operation.type = kOffset;
+      argument_count = 1;
+    } else if (name.compare("power") == 0) {
+      operation.type = kPower;
+      argument_count = 1;
+    } else if (name.compare("log") == 0) {
+      operation.type = kLog;
+      operation.a = FLT_MIN;
+      optional_argument_count = 1;
+    } else if (name.compare("clamp") == 0) {
+      operation.type = kClamp;
+      argument_count = 2;
+    } else if (name.compare("normalize") == 0) {
+      operation.type = kNormalize;
+      operation.a = 100.0f;
+      optional_argument_count = 1;
+    } else {
+      LOG_ERROR(_T("Unknown operation '%s' in post.operations"),
+                name.c_str());
+      return false;
+    }
+
+    unsigned int given_count = fields.size() - 1;
+    if (given_count < argument_count
+        || given_count > argument_count + optional_argument_count) {
+      LOG_ERROR(_T("Wrong number of arguments to '%s' in post.operations"),
+                operation_string.c_str());
+      return false;
+    }
+    if (given_count > 0) {
+      operation.a = atof(fields[1].c_str());
+    }
+    if (given_count > 1) {
+      operation.b = atof(fields[2].c_str());
+    }
+    if (operation.type == kNormalize && operation.a < 1.0f) {
+      LOG_ERROR(_T("The normalisation length in post.operations must be at "
+                   "least one frame"));
+      return false;
+    }
+    operations_.push_back(operation);
+  }
+  return true;
+}
+
+bool ModulePost::InitializeInternal(const SignalBank &input) {
+  // Copy the parameters of the input signal bank into internal variables, so
+  // that they can be checked later.
+  sample_rate_ = input.sample_rate();
+  buffer_length_ = input.buffer_length();
+  channel_count_ = input.channel_count();
+
+  if (!ParseOperations()) {
+    return false;
+  }
+
+  output_.Initialize(input);
+  ResetInternal();
+  return true;
+}
+
+void ModulePost::ResetInternal() {
+  frame_count_ = 0;
+  for (unsigned int o = 0; o < operations_.size(); ++o) {
+    if (operations_[o].type == kNormalize) {
+      operations_[o].mean.assign(channel_count_ * buffer_length_, 0.0f);
+      operations_[o].variance.assign(channel_count_ * buffer_length_, 0.0f);
+    }
+  }
+}
+
+void ModulePost::Process(const SignalBank &input) {
+  // Check to see if the module has been initialized. If not, processing
+  // should not continue.
+  if (!initialized_) {
+    LOG_ERROR(_T("Module %s not initialized."), module_identifier_.c_str());
+    return;
+  }
+
+  // Check that the input this time has the same channels as the input passed
+  // to Initialize(). The buffer length may vary. The normalisation state is
+  // held for buffer_length_ values per channel, and is restarted if a longer
+  // buffer arrives.
+  if (channel_count_ != input.channel_count()) {
+    LOG_ERROR(_T("Mismatch between input to Initialize() and input to "
+                 "Process() in module %s."), module_identifier_.c_str());
+    return;
+  }
+  int length = input.buffer_length();
+  if (length > buffer_length_) {
+    buffer_length_ = length;
+    ResetInternal();
+  }
+  output_.SetBufferLength(length);
+
+  output_.set_start_time(input.start_time());
+  output_.set_pitch_index(input.pitch_index());
+  ++frame_count_;
+
+  // Each channel is copied once into the output and the whole chain is
+  // applied to it there, while it is in cache. Each operation is a simple
+  // loop over the channel, which the compiler can vectorize.
+  for (int ch = 0; ch < channel_count_; ++ch) {
+    vector<float> &output_signal = output_.get_mutable_signal(ch);
+    const vector<float> &input_signal = input[ch];
+    float *values = &output_signal[0];
+    for (int i = 0; i < length; ++i) {
+      values[i] = input_signal[i];
+    }
+    for (unsigned int o = 0; o < operations_.size(); ++o) {
+      ApplyOperation(&operations_[o], ch, length, values);
+    }
+  }
+  PushOutput();
+}
+
+void ModulePost::ApplyOperation(Operation *operation, int channel,
+                                int length, float *values) {
+  switch (operation->type) {
+    case kScaleByCF: {
+      float cf = output_.centre_frequency(channel);
+      for (int i = 0; i < length; ++i) {
+        values[i] *= cf;
+      }
+      break;
+    }
+    case kScale: {
+      float scale = operation->a;
+      for (int i = 0; i < length; ++i) {
+        values[i] *= scale;
+      }
+      break;
+    }
+    case kOffset: {
+      float offset = operation->a;
+      for (int i = 0; i < length; ++i) {
+        values[i] += offset;
+      }
+      break;
+    }
+    case kPower: {
+      float power = operation->a;
+      if (power == 2.0f) {
+        for (int i = 0; i < length; ++i) {
+          values[i] *= values[i];
+        }
+      } else if (power == 0.5f) {
+        for (int i = 0; i < length; ++i) {
+          values[i] = sqrt(values[i]);
+        }
+      } else {
+        for (int i = 0; i < length; ++i) {
+          values[i] = pow(values[i], power);
+        }
+      }
+      break;
+    }
+    case kLog: {
+      float floor = operation->a;
+      for (int i = 0; i < length; ++i) {
+        values[i] = log(values[i] > floor ? values[i] : floor);
+      }
+      break;
+    }
+    case kClamp: {
+      float minimum = operation->a;
+      float maximum = operation->b;
+      for (int i = 0; i < length; ++i) {
+        float value = values[i] < minimum ? minimum : values[i];
+        values[i] = value > maximum ? maximum : value;
+      }
+      break;
+    }
+    case kNormalize: {
+      // Running mean and variance, updated with weight 1/n for the nth
+      // frame until n reaches the normalisation length, and with a fixed
+      // weight (an exponential window) after that
+      float weight = 1.0f / (frame_count_ < operation->a ? frame_count_
+                                                          : operation->a);
+      float *mean = &operation->mean[channel * buffer_length_];
+      float *variance = &operation->variance[channel * buffer_length_];
+      for (int i = 0; i < length; ++i) {
+        float delta = values[i] - mean[i];
+        mean[i] += weight * delta;
+        variance[i] += weight * (delta * (values[i] - mean[i]) - variance[i]);
+        values[i] = (values[i] - mean[i]) / sqrt(variance[i] + kVarianceFloor);
+      }
+      break;
+    }
+  }
+}
+}  // namespace aimc
@@ -0,0 +1,108 @@
+// Copyright 2026, agent
+//
+// AIM-C: A C++ implementation of the Auditory Image Model
+// http://www.acousticscale.org/AIMC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*! \file
+ *  \brief A chain of elementwise operations (scaling, power, log, clamping
+ *  and running normalisation) applied in a single pass
+ */
+
+/*!
+ * \author agent <agent@local>
+ * \date created 2026/10/19
+ * \version \$Id$
+ */
+
+#ifndef AIMC_MODULES_PROFILE_POST_H_
+#define AIMC_MODULES_PROFILE_POST_H_
+
+#include <string>
+#include <vector>
+
+#include "Support/Module.h"
+
+namespace aimc {
+using std::string;
+using std::vector;
+class ModulePost : public Module {
+ public:
+  explicit ModulePost(Parameters *pParam);
+  virtual ~ModulePost();
+
+  /*! \brief Process a buffer
+   */
+  virtual void Process(const SignalBank &input);
+
+ private:
+  /*! \brief Reset the internal state of the module
+   */
+  virtual void ResetInternal();
+
+  /*! \brief Prepare the module
+   *  \param input Input signal
+   *  \param output true on success false on failure
+   */
+  virtual bool InitializeInternal(const SignalBank &input);
+
+  enum OperationType {
+    kScaleByCF,
+    kScale,
+    kOffset,
+    kPower,
+    kLog,
+    kClamp,
+    kNormalize
+  };
+
+  /*! \brief A single operation in the chain
+   */
+  struct Operation {
+    OperationType type;
+    float a;
+    float b;
+    /*! \brief Running mean and variance of each value in the bank, for
+     *  normalisation
+     */
+    vector<float> mean;
+    vector<float> variance;
+  };
+
+  /*! \brief Parse the list of operations in operations_string_ into
+   *  operations_
+   */
+  bool ParseOperations();
+
+  /*! \brief Apply a single operation to the first length values of one
+   *  channel
+   */
+  void ApplyOperation(Operation *operation, int channel, int length,
+                      float *values);
+
+  float sample_rate_;
+  int buffer_length_;
+  int channel_count_;
+
+  string operations_string_;
+  vector<Operation> operations_;
+
+  /*! \brief Number of frames seen since the last reset, for the running
+   *  normalisation
+   */
+  int frame_count_;
+};
+}  // namespace aimc
+
+#endif  // AIMC_MODULES_PROFILE_POST_H_
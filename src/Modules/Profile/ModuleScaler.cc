@@ -55,16 +55,18 @@ void ModuleScaler::Process(const SignalBank &input) {
     return;
   }
 
-  // Check that ths input this time is the same as the input passed to
-  // Initialize()
-  if (buffer_length_ != input.buffer_length()
-      || channel_count_ != input.channel_count()) {
+  // Check that the input this time has the same channels as the input passed
+  // to Initialize(). The buffer length may vary.
+  if (channel_count_ != input.channel_count()) {
     LOG_ERROR(_T("Mismatch between input to Initialize() and input to "
                  "Process() in module %s."), module_identifier_.c_str());
     return;
   }
+  buffer_length_ = input.buffer_length();
+  output_.SetBufferLength(buffer_length_);
 
   output_.set_start_time(input.start_time());
+  output_.set_pitch_index(input.pitch_index());
 
   for (int ch = 0; ch < input.channel_count(); ++ch) {
     float cf = input.centre_frequency(ch);
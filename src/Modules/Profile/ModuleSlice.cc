@@ -36,8 +36,11 @@ ModuleSlice::ModuleSlice(Parameters *params) : Module(params) {
   take_all_ = parameters_->DefaultBool("slice.all", true);
   // If not taking all, then these give the lower and upper indices of the
   // section to take. They are bounds-checked.
-  lower_limit_ = parameters_->DefaultInt("slice.lower_index", 0);
-  upper_limit_ = parameters_->DefaultInt("slice.upper_index", 1000);
+  requested_lower_limit_ = parameters_->DefaultInt("slice.lower_index", 0);
+  requested_upper_limit_ = parameters_->DefaultInt("slice.upper_index",
+                                                   1000);
+  lower_limit_ = requested_lower_limit_;
+  upper_limit_ = requested_upper_limit_;
   // Set to true to normalize the slice taken (ie take the mean value)
   normalize_slice_ = parameters_->DefaultBool("slice.normalize", false);
 }
@@ -51,7 +54,19 @@ bool ModuleSlice::InitializeInternal(const SignalBank &input) {
   sample_rate_ = input.sample_rate();
   buffer_length_ = input.buffer_length();
   channel_count_ = input.channel_count();
+  SetLimits();
 
+  if (temporal_profile_) {
+    output_.Initialize(1, buffer_length_, sample_rate_);
+  } else {
+    output_.Initialize(channel_count_, 1, sample_rate_);
+  }
+  return true;
+}
+
+void ModuleSlice::SetLimits() {
+  lower_limit_ = requested_lower_limit_;
+  upper_limit_ = requested_upper_limit_;
   if (lower_limit_ < 0 || take_all_) {
     lower_limit_ = 0;
   }
@@ -80,13 +95,6 @@ bool ModuleSlice::InitializeInternal(const SignalBank &input) {
   if (slice_length_ < 1) {
     slice_length_ = 1;
   }
-
-  if (temporal_profile_) {
-    output_.Initialize(1, buffer_length_, sample_rate_);
-  } else {
-    output_.Initialize(channel_count_, 1, sample_rate_);
-  }
-  return true;
 }
 
 void ModuleSlice::ResetInternal() {
@@ -100,16 +108,23 @@ void ModuleSlice::Process(const SignalBank &input) {
     return;
   }
 
-  // Check that ths input this time is the same as the input passed to
-  // Initialize()
-  if (buffer_length_ != input.buffer_length()
-      || channel_count_ != input.channel_count()) {
+  // Check that the input this time has the same channels as the input passed
+  // to Initialize(). The buffer length may vary.
+  if (channel_count_ != input.channel_count()) {
     LOG_ERROR(_T("Mismatch between input to Initialize() and input to "
                  "Process() in module %s."), module_identifier_.c_str());
     return;
   }
+  if (buffer_length_ != input.buffer_length()) {
+    buffer_length_ = input.buffer_length();
+    SetLimits();
+    if (temporal_profile_) {
+      output_.SetBufferLength(buffer_length_);
+    }
+  }
 
   output_.set_start_time(input.start_time());
+  output_.set_pitch_index(input.pitch_index());
 
   if (temporal_profile_) {
     for (int i = 0; i < input.buffer_length(); ++i) {
@@ -117,9 +132,6 @@ void ModuleSlice::Process(const SignalBank &input) {
       for (int ch = lower_limit_; ch < upper_limit_; ++ch) {
         val += input.sample(ch, i);
       }
-      if (normalize_slice_) {
-        val /= static_cast<float>(slice_length_);
-      }
       output_.set_sample(0, i, val);
     }
   } else {
@@ -129,12 +141,49 @@ void ModuleSlice::Process(const SignalBank &input) {
       for (int i = lower_limit_; i < upper_limit_; ++i) {
         val += input.sample(ch, i);
       }
-      if (normalize_slice_) {
-        val /= static_cast<float>(slice_length_);
-      }
       output_.set_sample(ch, 0, val);
     }
   }
+  OutputProfile();
+}
+
+bool ModuleSlice::GetProfileRequest(ProfileRequest *request) const {
+  request->temporal = temporal_profile_;
+  request->lower_index = lower_limit_;
+  request->upper_index = upper_limit_;
+  return true;
+}
+
+void ModuleSlice::ProcessProfile(const SignalBank &profile) {
+  if (!initialized_) {
+    LOG_ERROR(_T("Module %s not initialized."), module_identifier_.c_str());
+    return;
+  }
+
+  output_.set_start_time(profile.start_time());
+  output_.set_pitch_index(profile.pitch_index());
+  if (temporal_profile_) {
+    for (int i = 0; i < buffer_length_; ++i) {
+      output_.set_sample(0, i, profile.sample(0, i));
+    }
+  } else {
+    for (int ch = 0; ch < channel_count_; ++ch) {
+      output_.set_centre_frequency(ch, profile.centre_frequency(ch));
+      output_.set_sample(ch, 0, profile.sample(ch, 0));
+    }
+  }
+  OutputProfile();
+}
+
+void ModuleSlice::OutputProfile() {
+  if (normalize_slice_) {
+    for (int ch = 0; ch < output_.channel_count(); ++ch) {
+      for (int i = 0; i < output_.buffer_length(); ++i) {
+        output_.set_sample(ch, i, output_.sample(ch, i)
+                                  / static_cast<float>(slice_length_));
+      }
+    }
+  }
   PushOutput();
 }
 }  // namespace aimc
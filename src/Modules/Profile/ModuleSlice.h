@@ -37,6 +37,15 @@ class ModuleSlice : public Module {
    */
   virtual void Process(const SignalBank &input);
 
+  /*! \brief The slice is a profile of the input, so sources may compute it
+   *  directly
+   */
+  virtual bool GetProfileRequest(ProfileRequest *request) const;
+
+  /*! \brief Process a profile of the input computed by the source module
+   */
+  virtual void ProcessProfile(const SignalBank &profile);
+
  private:
   /*! \brief Reset the internal state of the module
    */
@@ -48,12 +57,27 @@ class ModuleSlice : public Module {
    */
   virtual bool InitializeInternal(const SignalBank &input);
 
+  /*! \brief Normalize the profile in output_ if required, and push it to
+   *  the targets
+   */
+  void OutputProfile();
+
+  /*! \brief Bound the requested limits of the slice to the size of the input
+   */
+  void SetLimits();
+
   float sample_rate_;
   int buffer_length_;
   int channel_count_;
 
   bool temporal_profile_;
   bool take_all_;
+
+  /*! \brief Limits of the slice as given in the parameters, and as bounded
+   *  by the current input
+   */
+  int requested_lower_limit_;
+  int requested_upper_limit_;
   int lower_limit_;
   int upper_limit_;
   bool normalize_slice_;
@@ -29,6 +29,9 @@
 #include "Modules/SAI/ModuleSAI.h"
 
 namespace aimc {
+// The SAI buffer is renormalised when the output scale drops below this value
+static const float kMinOutputScale = 1e-6f;
+
 ModuleSAI::ModuleSAI(Parameters *parameters) : Module(parameters) {
   module_identifier_ = "weighted_sai";
   module_type_ = "sai";
@@ -43,13 +46,34 @@ ModuleSAI::ModuleSAI(Parameters *parameters) : Module(parameters) {
                                                    0.03f);
   frame_period_ms_ = parameters_->DefaultFloat("sai.frame_period_ms", 20.0f);
 
+  // If greater than zero, the SAI in each channel is only computed out to
+  // this many cycles of the channel's centre frequency (or sai.max_delay_ms,
+  // whichever is shorter). The remainder of each channel is left at zero.
+  max_delay_cycles_ = parameters_->DefaultFloat("sai.max_delay_cycles", 0.0f);
+
   max_concurrent_strobes_
     = parameters_->DefaultInt("sai.max_concurrent_strobes", 50);
 
+  // The SAI can be generated in one of two ways:
+  // "strobes" - Strobed temporal integration of the input, as in AIM
+  // "autocorrelation" - Running autocorrelation of each channel of the input,
+  //   smoothed with the same decay as the strobed SAI. Input strobes are
+  //   ignored, so the module can be fed directly from the NAP.
+  string mode = parameters_->DefaultString("sai.mode", "strobes");
+  autocorrelation_mode_ = false;
+  if (mode.compare("autocorrelation") == 0) {
+    autocorrelation_mode_ = true;
+  } else if (mode.compare("strobes") != 0) {
+    LOG_ERROR(_T("Unknown SAI mode '%s'. Using strobes."), mode.c_str());
+  }
+
   min_strobe_delay_idx_ = 0;
   max_strobe_delay_idx_ = 0;
   sai_decay_factor_ = 0.0f;
+  frame_decay_factor_ = 0.0f;
+  output_scale_ = 1.0f;
   fire_counter_ = 0;
+  acf_frame_fill_ = 0;
 }
 
 bool ModuleSAI::InitializeInternal(const SignalBank &input) {
@@ -72,8 +96,19 @@ bool ModuleSAI::InitializeInternal(const SignalBank &input) {
     output_.set_centre_frequency(i, input.centre_frequency(i));
   }
 
-  // sai_temp_ will be initialized to zero
-  if (!sai_temp_.Initialize(output_)) {
+  // Buffers for profiles of the SAI, for targets which only use a profile
+  if (!temporal_profile_.Initialize(1, sai_buffer_length, input.sample_rate())
+      || !spectral_profile_.Initialize(output_.channel_count(), 1,
+                                       input.sample_rate())) {
+    LOG_ERROR("Failed to create profile buffers in SAI module");
+    return false;
+  }
+  for (int i = 0; i < input.channel_count(); ++i) {
+    spectral_profile_.set_centre_frequency(i, input.centre_frequency(i));
+  }
+
+  // sai_buffer_ will be initialized to zero
+  if (!sai_buffer_.Initialize(output_)) {
     LOG_ERROR("Failed to create temporary buffer in SAI module");
     return false;
   }
@@ -94,6 +129,55 @@ bool ModuleSAI::InitializeInternal(const SignalBank &input) {
   sai_decay_factor_ = pow(0.5f, 1.0f / (buffer_memory_decay_
                                         * input.sample_rate()));
 
+  // Compute the length of the live region of each channel. One extra sample
+  // is kept beyond the final cycle so that modules which interpolate between
+  // lags (such as the SSI) have data for the whole of the final cycle.
+  channel_lag_count_.resize(channel_count_);
+  for (int ch = 0; ch < channel_count_; ++ch) {
+    int lag_count = max_strobe_delay_idx_;
+    float centre_frequency = input.centre_frequency(ch);
+    if (max_delay_cycles_ > 0.0f && centre_frequency > 0.0f) {
+      int cycle_lags = 2 + floor(max_delay_cycles_ * input.sample_rate()
+                                 / centre_frequency);
+      if (cycle_lags < lag_count)
+        lag_count = cycle_lags;
+    }
+    channel_lag_count_[ch] = lag_count;
+  }
+
+  // Decay of the whole SAI between one output frame and the next
+  frame_decay_factor_ = pow(sai_decay_factor_, frame_period_samples_);
+
+  // Precompute the decay applied to a sample, as a function of the number
+  // of samples until the next output frame. frame_decay_[i] is the decay for
+  // the i-th sample of a frame, so that the weights for a run of samples are
+  // contiguous.
+  frame_decay_.resize(frame_period_samples_ > 0 ? frame_period_samples_ : 1);
+  for (int i = 0; i < static_cast<int>(frame_decay_.size()); ++i) {
+    frame_decay_[i] = pow(sai_decay_factor_, frame_period_samples_ - 1 - i);
+  }
+
+  // Buffers for the autocorrelation mode. The history holds the maximum lag
+  // plus one frame of input, and the FFT must be long enough that the
+  // correlation of the frame with the history does not wrap around.
+  if (autocorrelation_mode_) {
+    int frame_length = frame_decay_.size();
+    acf_history_.resize(channel_count_);
+    acf_frame_.resize(channel_count_);
+    for (int ch = 0; ch < channel_count_; ++ch) {
+      acf_history_[ch].resize(max_strobe_delay_idx_ + frame_length);
+      acf_frame_[ch].resize(frame_length);
+    }
+    int fft_size = FFT::NextPowerOfTwo(max_strobe_delay_idx_ + frame_length);
+    if (!fft_.Initialize(fft_size)) {
+      LOG_ERROR(_T("Failed to initialize FFT in SAI module"));
+      return false;
+    }
+    acf_frame_fft_.resize(fft_size);
+    acf_history_fft_.resize(fft_size);
+    acf_product_fft_.resize(fft_size);
+  }
+
   // Precompute strobe weights
   strobe_weights_.resize(max_concurrent_strobes_);
   for (int n = 0; n < max_concurrent_strobes_; ++n) {
@@ -108,35 +192,109 @@ bool ModuleSAI::InitializeInternal(const SignalBank &input) {
 void ModuleSAI::ResetInternal() {
   // Active Strobes
   output_.Clear();
-  sai_temp_.Clear();
+  sai_buffer_.Clear();
+  output_scale_ = 1.0f;
   active_strobes_.clear();
   active_strobes_.resize(channel_count_);
+  for (unsigned int ch = 0; ch < acf_history_.size(); ++ch) {
+    acf_history_[ch].assign(acf_history_[ch].size(), 0.0f);
+  }
+  acf_frame_fill_ = 0;
   fire_counter_ = frame_period_samples_ - 1;
+  previous_buffer_length_ = 0;
+}
+
+// Add the contribution of a single strobe to a contiguous run of the SAI
+// buffer. sig, decay and sai point at the first input sample of the run, its
+// decay factor and the SAI lag that it contributes to, respectively. The
+// loop has no dependencies between iterations, so that it can be vectorized
+// by the compiler.
+static inline void AccumulateStrobe(float *sai,
+                                    const float *sig,
+                                    const float *decay,
+                                    float working_weight,
+                                    int length) {
+  for (int i = 0; i < length; ++i) {
+    sai[i] += sig[i] * working_weight * decay[i];
+  }
 }
 
 void ModuleSAI::Process(const SignalBank &input) {
-  // Reset the next strobe times
-  next_strobes_.clear();
-  next_strobes_.resize(output_.channel_count(), 0);
+  if (!autocorrelation_mode_) {
+    // Reset the next strobe times
+    next_strobes_.clear();
+    next_strobes_.resize(output_.channel_count(), 0);
 
-  // Offset the times on the strobes from the previous buffer
-  for (int ch = 0; ch < input.channel_count(); ++ch) {
-    active_strobes_[ch].ShiftStrobes(input.buffer_length());
+    // Offset the times on the strobes from the previous buffer, which may
+    // not have been the same length as this one
+    for (int ch = 0; ch < input.channel_count(); ++ch) {
+      active_strobes_[ch].ShiftStrobes(previous_buffer_length_);
+    }
+    previous_buffer_length_ = input.buffer_length();
   }
 
-  // Loop over samples to make the SAI
-  for (int i = 0; i < input.buffer_length(); ++i) {
-    float decay_factor = pow(sai_decay_factor_, fire_counter_);
-    // Loop over channels
-    for (int ch = 0; ch < input.channel_count(); ++ch) {
-      // Local convenience variables
-      StrobeList &active_strobes = active_strobes_[ch];
-      int next_strobe_index = next_strobes_[ch];
+  // The input buffer is processed in segments which end either at the end
+  // of the buffer or on a sample at which an output frame is due.
+  int segment_start = 0;
+  while (segment_start < input.buffer_length()) {
+    int segment_end = segment_start + fire_counter_;
+    if (fire_counter_ < 1)
+      segment_end = segment_start + 1;
+    if (segment_end > input.buffer_length())
+      segment_end = input.buffer_length();
+
+    // The weight applied to sample i to account for the decay until the next
+    // output frame is sample_decay[i - segment_start]
+    int decay_offset = frame_period_samples_ - 1 - fire_counter_;
+    if (decay_offset < 0)
+      decay_offset = 0;
+    const float *sample_decay = &frame_decay_[decay_offset];
+
+    if (autocorrelation_mode_) {
+      BufferAutocorrelationInput(input, segment_start, segment_end,
+                                 sample_decay);
+    } else {
+      AccumulateStrobes(input, segment_start, segment_end, sample_decay);
+    }
+
+    fire_counter_ -= segment_end - segment_start;
+
+    // Check to see if we need to output an SAI frame on this sample
+    if (fire_counter_ <= 0) {
+      if (autocorrelation_mode_)
+        AccumulateAutocorrelation();
+      OutputFrame(input.start_time() + segment_end - 1);
+    }
+    segment_start = segment_end;
+  }  // End loop over segments
+}
+
+void ModuleSAI::AccumulateStrobes(const SignalBank &input,
+                                  int segment_start,
+                                  int segment_end,
+                                  const float *sample_decay) {
+  // The SAI buffer is stored divided by output_scale_, so new values are
+  // scaled up by the inverse before they are added
+  float accumulation_scale = 1.0f / output_scale_;
 
+  // Loop over channels
+  for (int ch = 0; ch < input.channel_count(); ++ch) {
+    // Local convenience variables
+    StrobeList &active_strobes = active_strobes_[ch];
+    int next_strobe_index = next_strobes_[ch];
+    int lag_count = channel_lag_count_[ch];
+    const float *sig = &input[ch][0];
+    float *sai = &sai_buffer_.get_mutable_signal(ch)[0];
+
+    // The set of active strobes, and their weights, only changes when a
+    // new strobe arrives, so the segment is further split into runs of
+    // samples between strobes.
+    int run_start = segment_start;
+    while (run_start < segment_end) {
       // Update strobes
-      // If we are up to or beyond the next strobe...
+      // If we are up to the next strobe...
       if (next_strobe_index < input.strobe_count(ch)) {
-        if (i == input.strobe(ch, next_strobe_index)) {
+        if (run_start == input.strobe(ch, next_strobe_index)) {
           // A new strobe has arrived.
           // If there are too many strobes active, then get rid of the
           // earliest one
@@ -153,15 +311,14 @@ void ModuleSAI::Process(const SignalBank &input) {
 
             // If the strobe occured within 10 impulse-response
             // cycles of the previous strobe, then lower its weight
-            weight = (i - last_strobe_time) / input.sample_rate()
+            weight = (run_start - last_strobe_time) / input.sample_rate()
                      * input.centre_frequency(ch) / 10.0f;
             if (weight > 1.0f)
               weight = 1.0f;
           }
-          active_strobes.AddStrobe(i, weight);
+          active_strobes.AddStrobe(run_start, weight);
           next_strobe_index++;
 
-
           // Update the strobe weights
           float total_strobe_weight = 0.0f;
           for (int si = 0; si < active_strobes.strobe_count(); ++si) {
@@ -177,72 +334,238 @@ void ModuleSAI::Process(const SignalBank &input) {
         }
       }
 
-      // Remove inactive strobes
+      // The run continues up to the arrival of the next strobe, or the end
+      // of the segment.
+      int run_end = segment_end;
+      if (next_strobe_index < input.strobe_count(ch)) {
+        int next_strobe_time = input.strobe(ch, next_strobe_index);
+        if (next_strobe_time > run_start && next_strobe_time < run_end)
+          run_end = next_strobe_time;
+      }
+
+      // Update the SAI buffer with the weighted effect of each of the active
+      // strobes over the whole run
+      for (int si = 0; si < active_strobes.strobe_count(); ++si) {
+        StrobePoint strobe = active_strobes.Strobe(si);
+        // A strobe contributes to the SAI at all samples for which the
+        // delay, the time from the strobe event to now, is between the
+        // (user-set) minimum and maximum strobe delays, and inside the
+        // live region of the channel
+        int begin = strobe.time + min_strobe_delay_idx_;
+        int end = strobe.time + lag_count;
+        if (begin < run_start)
+          begin = run_start;
+        if (end > run_end)
+          end = run_end;
+        if (begin < end) {
+          AccumulateStrobe(sai + (begin - strobe.time),
+                           sig + begin,
+                           sample_decay + (begin - segment_start),
+                           strobe.working_weight * accumulation_scale,
+                           end - begin);
+        }
+      }
+
+      // Remove inactive strobes. Strobes are kept until the full maximum
+      // delay has passed even if the channel's live region is shorter, so
+      // that the strobe weights are the same as for the full SAI.
       while (active_strobes.strobe_count() > 0) {
-        // Get the relative time of the first strobe, and see if it exceeds
-        // the maximum allowed time.
-        if ((i - active_strobes.Strobe(0).time) > max_strobe_delay_idx_)
+        // Get the relative time of the first strobe at the last sample of
+        // the run, and see if it exceeds the maximum allowed time.
+        if ((run_end - 1 - active_strobes.Strobe(0).time)
+            > max_strobe_delay_idx_)
           active_strobes.DeleteFirstStrobe();
         else
           break;
       }
+      run_start = run_end;
+    }
+    next_strobes_[ch] = next_strobe_index;
+  }  // End loop over channels
+}
 
-      // Update the SAI buffer with the weighted effect of all the active
-      // strobes at the current sample
-      for (int si = 0; si < active_strobes.strobe_count(); ++si) {
-        // Add the effect of active strobe at correct place in the SAI buffer
-        // Calculate 'delay', the time from the strobe event to now
-        int delay = i - active_strobes.Strobe(si).time;
-
-        // If the delay is greater than the (user-set)
-        // minimum strobe delay, the strobe can be used
-        if (delay >= min_strobe_delay_idx_ && delay < max_strobe_delay_idx_) {
-          // The value at be added to the SAI
-          float sig = input.sample(ch, i);
-
-          // Weight the sample correctly
-          sig *= active_strobes.Strobe(si).working_weight;
+void ModuleSAI::BufferAutocorrelationInput(const SignalBank &input,
+                                           int segment_start,
+                                           int segment_end,
+                                           const float *sample_decay) {
+  // The raw input is appended to the history after the maximum lag, and the
+  // input weighted by the decay until the next frame is kept separately.
+  int length = segment_end - segment_start;
+  for (int ch = 0; ch < channel_count_; ++ch) {
+    const float *sig = &input[ch][segment_start];
+    float *history = &acf_history_[ch][max_strobe_delay_idx_
+                                       + acf_frame_fill_];
+    float *frame = &acf_frame_[ch][acf_frame_fill_];
+    for (int i = 0; i < length; ++i) {
+      history[i] = sig[i];
+      frame[i] = sig[i] * sample_decay[i];
+    }
+  }
+  acf_frame_fill_ += length;
+}
 
-          // Adjust the weight acording to the number of samples until the
-          // next output frame
-          sig *= decay_factor;
+void ModuleSAI::AccumulateAutocorrelation() {
+  // The contribution of the frame to lag l of the SAI is the sum over the
+  // samples n in the frame of frame[n] * history[n - l], where history
+  // includes the max_strobe_delay_idx_ samples before the start of the
+  // frame. This is computed as a cross-correlation via the FFT, with
+  // channels transformed in pairs as the real and imaginary parts of a
+  // single complex transform.
+  int fft_size = fft_.size();
+  int max_lag = max_strobe_delay_idx_;
+  int history_length = max_lag + acf_frame_fill_;
+  float accumulation_scale = 1.0f / output_scale_;
+  complex<float> half(0.5f, 0.0f);
+  complex<float> minus_half_i(0.0f, -0.5f);
+  complex<float> i_unit(0.0f, 1.0f);
+
+  for (int ch = 0; ch < channel_count_; ch += 2) {
+    bool paired = (ch + 1 < channel_count_);
+    for (int i = 0; i < fft_size; ++i) {
+      float frame_a = 0.0f, frame_b = 0.0f;
+      if (i < acf_frame_fill_) {
+        frame_a = acf_frame_[ch][i];
+        if (paired)
+          frame_b = acf_frame_[ch + 1][i];
+      }
+      acf_frame_fft_[i] = complex<float>(frame_a, frame_b);
 
-          // Update the temporary SAI buffer
-          sai_temp_.set_sample(ch, delay, sai_temp_.sample(ch, delay) + sig);
-        }
+      float history_a = 0.0f, history_b = 0.0f;
+      if (i < history_length) {
+        history_a = acf_history_[ch][i];
+        if (paired)
+          history_b = acf_history_[ch + 1][i];
+      }
+      acf_history_fft_[i] = complex<float>(history_a, history_b);
+    }
+    fft_.Transform(&acf_frame_fft_, false);
+    fft_.Transform(&acf_history_fft_, false);
+
+    // Separate the spectra of the two channels, form the cross-spectra, and
+    // pack them back together for a single inverse transform.
+    for (int k = 0; k < fft_size; ++k) {
+      int nk = (fft_size - k) & (fft_size - 1);
+      complex<float> f_k = acf_frame_fft_[k];
+      complex<float> f_nk = conj(acf_frame_fft_[nk]);
+      complex<float> h_k = acf_history_fft_[k];
+      complex<float> h_nk = conj(acf_history_fft_[nk]);
+      complex<float> frame_a = (f_k + f_nk) * half;
+      complex<float> frame_b = (f_k - f_nk) * minus_half_i;
+      complex<float> history_a = (h_k + h_nk) * half;
+      complex<float> history_b = (h_k - h_nk) * minus_half_i;
+      acf_product_fft_[k] = conj(frame_a) * history_a
+                            + i_unit * conj(frame_b) * history_b;
+    }
+    fft_.Transform(&acf_product_fft_, true);
+
+    // Element max_lag - l of the cross-correlation is lag l of the SAI
+    for (int pair = 0; pair < 2 && ch + pair < channel_count_; ++pair) {
+      float *sai = &sai_buffer_.get_mutable_signal(ch + pair)[0];
+      for (int lag = min_strobe_delay_idx_; lag < channel_lag_count_[ch + pair];
+           ++lag) {
+        complex<float> value = acf_product_fft_[max_lag - lag];
+        float correlation = (pair == 0) ? value.real() : value.imag();
+        sai[lag] += correlation * accumulation_scale;
       }
+    }
+  }
 
-      next_strobes_[ch] = next_strobe_index;
-    }  // End loop over channels
+  // Keep the most recent max_lag samples as the history for the next frame
+  for (int ch = 0; ch < channel_count_; ++ch) {
+    vector<float> &history = acf_history_[ch];
+    for (int i = 0; i < max_lag; ++i)
+      history[i] = history[i + acf_frame_fill_];
+  }
+  acf_frame_fill_ = 0;
+}
 
-    fire_counter_--;
+void ModuleSAI::OutputFrame(int start_time) {
+  // If every target only uses a profile of the SAI, the profiles are
+  // computed directly from the SAI buffer, and the full output frame is not
+  // generated.
+  if (TargetsUseProfilesOnly()) {
+    ProfileRequest request;
+    set<Module*>::const_iterator it;
+    for (it = targets_.begin(); it != targets_.end(); ++it) {
+      (*it)->GetProfileRequest(&request);
+      if (request.temporal) {
+        ComputeTemporalProfile(request.lower_index, request.upper_index);
+        temporal_profile_.set_start_time(start_time);
+        (*it)->ProcessProfile(temporal_profile_);
+      } else {
+        ComputeSpectralProfile(request.lower_index, request.upper_index);
+        spectral_profile_.set_start_time(start_time);
+        (*it)->ProcessProfile(spectral_profile_);
+      }
+    }
+  } else if (TargetsAcceptScaledInput()) {
+    // Targets such as the SSI read the SAI buffer directly, applying the
+    // scale factor as they go, so the output frame is not generated either.
+    // Only the live region of each channel of the buffer is ever non-zero,
+    // as in the output.
+    sai_buffer_.set_start_time(start_time);
+    set<Module*>::const_iterator it;
+    for (it = targets_.begin(); it != targets_.end(); ++it) {
+      (*it)->ProcessScaled(sai_buffer_, output_scale_);
+    }
+  } else {
+    // Scale the SAI buffer to give the output frame. Only the live region
+    // of each channel is ever non-zero.
+    for (int ch = 0; ch < channel_count_; ++ch) {
+      const float *sai = &sai_buffer_[ch][0];
+      float *out = &output_.get_mutable_signal(ch)[0];
+      for (int i = 0; i < channel_lag_count_[ch]; ++i) {
+        out[i] = sai[i] * output_scale_;
+      }
+    }
 
-    // Check to see if we need to output an SAI frame on this sample
-    if (fire_counter_ <= 0) {
-      // Decay the SAI by the correct amount and add the current output frame
-      float decay = pow(sai_decay_factor_, frame_period_samples_);
+    // Transfer the current time to the output buffer
+    output_.set_start_time(start_time);
+    PushOutput();
+  }
 
-      for (int ch = 0; ch < input.channel_count(); ++ch) {
-        for (int i = 0; i < output_.buffer_length(); ++i) {
-          output_.set_sample(ch, i,
-                             sai_temp_[ch][i] + output_[ch][i] * decay);
-        }
+  // Decay the SAI by the correct amount before the next frame. Rather
+  // than rescaling the whole buffer, the decay is folded into the scale
+  // factor. When the scale factor becomes small, it is applied to the
+  // buffer and reset, to keep the buffer values in a sensible range.
+  output_scale_ *= frame_decay_factor_;
+  if (output_scale_ < kMinOutputScale) {
+    for (int ch = 0; ch < sai_buffer_.channel_count(); ++ch) {
+      float *sai = &sai_buffer_.get_mutable_signal(ch)[0];
+      for (int i = 0; i < channel_lag_count_[ch]; ++i) {
+        sai[i] *= output_scale_;
       }
+    }
+    output_scale_ = 1.0f;
+  }
 
-      // Zero the temporary signal
-      for (int ch = 0; ch < sai_temp_.channel_count(); ++ch) {
-        for (int i = 0; i < sai_temp_.buffer_length(); ++i) {
-          sai_temp_.set_sample(ch, i, 0.0f);
-        }
-      }
+  fire_counter_ = frame_period_samples_ - 1;
+}
 
-      fire_counter_ = frame_period_samples_ - 1;
+void ModuleSAI::ComputeTemporalProfile(int lower_channel, int upper_channel) {
+  // The channels are summed in order, one row at a time.
+  vector<float> &profile = temporal_profile_.get_mutable_signal(0);
+  profile.assign(profile.size(), 0.0f);
+  for (int ch = lower_channel; ch < upper_channel; ++ch) {
+    const float *sai = &sai_buffer_[ch][0];
+    for (int i = 0; i < channel_lag_count_[ch]; ++i) {
+      profile[i] += sai[i] * output_scale_;
+    }
+  }
+}
 
-      // Transfer the current time to the output buffer
-      output_.set_start_time(input.start_time() + i);
-      PushOutput();
+void ModuleSAI::ComputeSpectralProfile(int lower_lag, int upper_lag) {
+  for (int ch = 0; ch < channel_count_; ++ch) {
+    const float *sai = &sai_buffer_[ch][0];
+    int end = upper_lag;
+    if (end > channel_lag_count_[ch])
+      end = channel_lag_count_[ch];
+    float value = 0.0f;
+    for (int i = lower_lag; i < end; ++i) {
+      value += sai[i] * output_scale_;
     }
-  }  // End loop over samples
+    spectral_profile_.set_sample(ch, 0, value);
+  }
 }
 
 ModuleSAI::~ModuleSAI() {
@@ -26,13 +26,18 @@
 #ifndef AIMC_MODULES_SAI_SAI_H_
 #define AIMC_MODULES_SAI_SAI_H_
 
+#include <complex>
+#include <string>
 #include <vector>
 
+#include "Support/FFT.h"
 #include "Support/Module.h"
 #include "Support/SignalBank.h"
 #include "Support/StrobeList.h"
 
 namespace aimc {
+using std::complex;
+using std::string;
 using std::vector;
 class ModuleSAI : public Module {
  public:
@@ -49,9 +54,58 @@ class ModuleSAI : public Module {
 
   virtual void ResetInternal();
 
-  /*! \brief Temporary buffer for constructing the current SAI frame
+  /*! \brief Add the contribution of the active strobes in each channel
+   *  over a segment of the input which lies within a single frame
    */
-  SignalBank sai_temp_;
+  void AccumulateStrobes(const SignalBank &input,
+                         int segment_start,
+                         int segment_end,
+                         const float *sample_decay);
+
+  /*! \brief Store a segment of the input for the autocorrelation mode
+   */
+  void BufferAutocorrelationInput(const SignalBank &input,
+                                  int segment_start,
+                                  int segment_end,
+                                  const float *sample_decay);
+
+  /*! \brief Add the autocorrelation of the buffered frame of input to the
+   *  SAI buffer
+   */
+  void AccumulateAutocorrelation();
+
+  /*! \brief Generate an output frame from the SAI buffer, push it to the
+   *  targets, and decay the buffer
+   *
+   * If every target only uses a profile of the SAI (see
+   * Module::GetProfileRequest()), then only the profiles are computed and
+   * output_ is not updated.
+   */
+  void OutputFrame(int start_time);
+
+  /*! \brief Compute the temporal profile of the current SAI frame over
+   *  channels lower_channel to upper_channel - 1 into temporal_profile_
+   */
+  void ComputeTemporalProfile(int lower_channel, int upper_channel);
+
+  /*! \brief Compute the spectral profile of the current SAI frame over
+   *  lags lower_lag to upper_lag - 1 into spectral_profile_
+   */
+  void ComputeSpectralProfile(int lower_lag, int upper_lag);
+
+  /*! \brief Buffer in which the SAI is accumulated. The SAI itself is
+   *  sai_buffer_ multiplied by output_scale_.
+   */
+  SignalBank sai_buffer_;
+
+  /*! \brief Scale factor applied to sai_buffer_ to give the output SAI
+   */
+  float output_scale_;
+
+  /*! \brief Profiles of the SAI for targets which only use a profile
+   */
+  SignalBank temporal_profile_;
+  SignalBank spectral_profile_;
 
   /*! \brief List of strobes for each channel
    */
@@ -73,6 +127,14 @@ class ModuleSAI : public Module {
    */
   float sai_decay_factor_;
 
+  /*! \brief Factor with which the SAI is decayed between output frames
+   */
+  float frame_decay_factor_;
+
+  /*! \brief Precomputed decay factors for each sample position in a frame
+   */
+  vector<float> frame_decay_;
+
   /*! \brief Precomputed 1/n^alpha values for strobe weighting
    */
   vector<float> strobe_weights_;
@@ -90,6 +152,11 @@ class ModuleSAI : public Module {
 
   int fire_counter_;
 
+  /*! \brief Length of the previous input buffer, by which the times of the
+   *  active strobes are shifted when the next buffer arrives
+   */
+  int previous_buffer_length_;
+
   /*! \brief Period in milliseconds between output frames
    */
   float frame_period_ms_;
@@ -97,7 +164,40 @@ class ModuleSAI : public Module {
 
   float min_delay_ms_;
   float max_delay_ms_;
+
+  /*! \brief Maximum delay in cycles of the channel centre frequency, or zero
+   *  to use max_delay_ms_ in all channels
+   */
+  float max_delay_cycles_;
+
+  /*! \brief Number of lags in each channel which are computed
+   */
+  vector<int> channel_lag_count_;
+
   int channel_count_;
+
+  /*! \brief True to generate the SAI by autocorrelation rather than by
+   *  strobed temporal integration
+   */
+  bool autocorrelation_mode_;
+
+  /*! \brief Input history for the autocorrelation mode; the maximum lag
+   *  followed by the current frame
+   */
+  vector<vector<float> > acf_history_;
+
+  /*! \brief Input for the current frame weighted by the frame decay
+   */
+  vector<vector<float> > acf_frame_;
+
+  /*! \brief Number of samples of input in the current frame
+   */
+  int acf_frame_fill_;
+
+  FFT fft_;
+  vector<complex<float> > acf_frame_fft_;
+  vector<complex<float> > acf_history_fft_;
+  vector<complex<float> > acf_product_fft_;
 };
 }  // namespace aimc
 
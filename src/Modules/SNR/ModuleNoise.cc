@@ -73,14 +73,15 @@ void ModuleNoise::Process(const SignalBank &input) {
     return;
   }
 
-  // Check that ths input this time is the same as the input passed to
-  // Initialize()
-  if (buffer_length_ != input.buffer_length()
-      || channel_count_ != input.channel_count()) {
+  // Check that the input this time has the same channels as the input passed
+  // to Initialize(). The buffer length may vary.
+  if (channel_count_ != input.channel_count()) {
     LOG_ERROR(_T("Mismatch between input to Initialize() and input to "
                  "Process() in module %s."), module_identifier_.c_str());
     return;
   }
+  buffer_length_ = input.buffer_length();
+  output_.SetBufferLength(buffer_length_);
 
   for (int c = 0; c < input.channel_count(); ++c) {
     for (int i = 0; i < input.buffer_length(); ++i) {
@@ -21,11 +21,18 @@
  * \version \$Id$
  */
 
+#include <algorithm>
 #include <cmath>
 
 #include "Modules/SSI/ModuleSSI.h"
 
 namespace aimc {
+// The smooth pitch offset is tabulated for arguments to tanh() in the range
+// -kPitchRampRange to kPitchRampRange, at kPitchRampResolution points per
+// unit. Outside this range, the ramp is taken to be 0 or 1.
+static const float kPitchRampRange = 10.0f;
+static const int kPitchRampResolution = 512;
+
 #ifdef _MSC_VER
 // MSVC doesn't define log2()
 float log2(float n) {
@@ -119,37 +126,126 @@ bool ModuleSSI::InitializeInternal(const SignalBank &input) {
   }
   
   output_.Initialize(channel_count_, ssi_width_samples_, sample_rate_);
+
+  profile_row_.resize(ssi_width_samples_);
+
+  // Precompute, for each channel and each SSI sample, the index of the input
+  // sample to interpolate from, and the fractional part used for linear
+  // interpolation. The tables are stored flat, one channel after another.
+  gather_index_.resize(channel_count_ * ssi_width_samples_);
+  gather_fraction_.resize(channel_count_ * ssi_width_samples_);
+  gather_count_.resize(channel_count_);
+  channel_scaling_.resize(channel_count_);
+  cycle_samples_.resize(channel_count_);
+  for (int ch = 0; ch < channel_count_; ++ch) {
+    float centre_frequency = input.centre_frequency(ch);
+    float cycle_samples = sample_rate_ / centre_frequency;
+    cycle_samples_[ch] = cycle_samples;
+
+    // Weight the values in the channel more strongly if it was scaled such
+    // that the end goes off the edge of the SSI.
+    channel_scaling_[ch] = 1.0f;
+    if (weight_by_scaling_ && centre_frequency > pivot_cf_) {
+      channel_scaling_[ch] = centre_frequency / pivot_cf_;
+    }
+
+    // The index into the input array is a floating-point number, which is
+    // split into a whole part and a fractional part. The whole part and
+    // fractional part are found, and are used to linearly interpolate
+    // between input samples to yield an output sample.
+    for (int i = 0; i < ssi_width_samples_; ++i) {
+      double whole_part;
+      float frac_part = modf(h_[i] * cycle_samples, &whole_part);
+      int sample = floor(whole_part);
+      gather_index_[ch * ssi_width_samples_ + i] = sample;
+      gather_fraction_[ch * ssi_width_samples_ + i] = frac_part;
+    }
+  }
+  SetBufferLength(buffer_length_);
+
+  // Tabulate the ramp (1 + tanh(x)) / 2 used for smoothing around the pitch
+  // cutoff
+  if (do_smooth_offset_) {
+    int ramp_length = 2 * kPitchRampRange * kPitchRampResolution + 1;
+    pitch_ramp_.resize(ramp_length);
+    for (int i = 0; i < ramp_length; ++i) {
+      float x = static_cast<float>(i) / kPitchRampResolution
+                - kPitchRampRange;
+      pitch_ramp_[i] = (1.0f + tanh(x)) / 2.0f;
+    }
+  }
+  SetUpProfiles();
   return true;
 }
 
-void ModuleSSI::ResetInternal() {
-}
+void ModuleSSI::SetBufferLength(int buffer_length) {
+  buffer_length_ = buffer_length;
+  sai_temporal_profile_.resize(buffer_length_);
 
-int ModuleSSI::ExtractPitchIndex(const SignalBank &input) const {
-  // Generate temporal profile of the SAI
-  vector<float> sai_temporal_profile(buffer_length_, 0.0f);
-  for (int i = 0; i < buffer_length_; ++i) {
-    float val = 0.0f;
-    for (int ch = 0; ch < channel_count_; ++ch) {
-      val += input.sample(ch, i);
+  // Samples from gather_count_[ch] onwards would interpolate past the end
+  // of the input buffer, and are always zero.
+  for (int ch = 0; ch < channel_count_; ++ch) {
+    const int *index = &gather_index_[ch * ssi_width_samples_];
+    gather_count_[ch] = 0;
+    for (int i = 0; i < ssi_width_samples_; ++i) {
+      if (index[i] < buffer_length_ - 1)
+        gather_count_[ch] = i + 1;
     }
-    sai_temporal_profile[i] = val;
   }
+}
+
+float ModuleSSI::PitchRamp(float x) const {
+  float position = (x + kPitchRampRange) * kPitchRampResolution;
+  if (position <= 0.0f)
+    return 0.0f;
+  int index = position;
+  if (index >= static_cast<int>(pitch_ramp_.size()) - 1)
+    return 1.0f;
+  float frac = position - index;
+  return pitch_ramp_[index] + frac * (pitch_ramp_[index + 1]
+                                      - pitch_ramp_[index]);
+}
+
+void ModuleSSI::ResetInternal() {
+}
 
-  // Find pitch value
+int ModuleSSI::ExtractPitchIndex(const SignalBank &input, float scale) {
+  // Generate the temporal profile of the SAI one channel at a time, and look
+  // for the maximum, after the start of the search, while adding the final
+  // channel.
   int start_sample = floor(pitch_search_start_ms_ * sample_rate_ / 1000.0f);
   int max_idx = 0;
   float max_val = 0.0f;
-  for (int i = start_sample; i < buffer_length_; ++i) {
-    if (sai_temporal_profile[i] > max_val) {
+  float *profile = &sai_temporal_profile_[0];
+  for (int i = 0; i < buffer_length_; ++i) {
+    profile[i] = 0.0f;
+  }
+  for (int ch = 0; ch < channel_count_ - 1; ++ch) {
+    const float *sai = &input[ch][0];
+    for (int i = 0; i < buffer_length_; ++i) {
+      profile[i] += sai[i] * scale;
+    }
+  }
+  const float *sai = &input[channel_count_ - 1][0];
+  for (int i = 0; i < buffer_length_; ++i) {
+    profile[i] += sai[i] * scale;
+    if (i >= start_sample && profile[i] > max_val) {
       max_idx = i;
-      max_val = sai_temporal_profile[i];
+      max_val = profile[i];
     }
   }
   return max_idx;
 }
 
+bool ModuleSSI::AcceptsScaledInput() const {
+  return true;
+}
+
 void ModuleSSI::Process(const SignalBank &input) {
+  ProcessScaled(input, 1.0f);
+}
+
+void ModuleSSI::ProcessScaled(const SignalBank &input, float scale) {
   // Check to see if the module has been initialized. If not, processing
   // should not continue.
   if (!initialized_) {
@@ -157,26 +253,54 @@ void ModuleSSI::Process(const SignalBank &input) {
     return;
   }
 
-  // Check that ths input this time is the same as the input passed to
-  // Initialize()
-  if (buffer_length_ != input.buffer_length()
-      || channel_count_ != input.channel_count()) {
+  // Check that the input this time has the same channels as the input passed
+  // to Initialize(). The buffer length may vary, in which case the SSI keeps
+  // the width it was given at initialization.
+  if (channel_count_ != input.channel_count()) {
     LOG_ERROR(_T("Mismatch between input to Initialize() and input to "
                  "Process() in module %s."), module_identifier_.c_str());
     return;
   }
+  if (buffer_length_ != input.buffer_length()) {
+    SetBufferLength(input.buffer_length());
+  }
 
   output_.set_start_time(input.start_time());
 
+  // Use the pitch of the input if an earlier module has already found it.
+  // Otherwise, find it if it's needed.
   int pitch_index = buffer_length_ - 1;
+  output_.set_pitch_index(input.pitch_index());
   if (do_pitch_cutoff_) {
-    pitch_index = ExtractPitchIndex(input);
+    if (input.pitch_index() >= 0) {
+      pitch_index = input.pitch_index();
+    } else {
+      pitch_index = ExtractPitchIndex(input, scale);
+      output_.set_pitch_index(pitch_index);
+    }
   }
 
+  // tanh(3) is about 0.995. Seems reasonable.
+  float smooth_pitch_constant = 3.0f / smooth_offset_cycles_;
+
+  // If every target only uses a profile of the SSI, each channel of the SSI
+  // is built in a scratch row and reduced into the profiles straight away,
+  // rather than generating the whole SSI.
+  bool profiles_only = TargetsUseProfilesOnly();
+  if (profiles_only)
+    PrepareProfiles();
+
   for (int ch = 0; ch < channel_count_; ++ch) {
-    float centre_frequency = input.centre_frequency(ch);
-    float cycle_samples = sample_rate_ / centre_frequency;
-    
+    const int *index = &gather_index_[ch * ssi_width_samples_];
+    const float *fraction = &gather_fraction_[ch * ssi_width_samples_];
+    const float *sig = &input[ch][0];
+    float *out;
+    if (profiles_only) {
+      out = &profile_row_[0];
+    } else {
+      out = &output_.get_mutable_signal(ch)[0];
+    }
+
     float channel_weight = 1.0f;
     int cutoff_index = buffer_length_ - 1;
     if (do_pitch_cutoff_) {
@@ -188,54 +312,114 @@ void ModuleSSI::Process(const SignalBank &input) {
         cutoff_index = pitch_index;
       }
     }
-    
-    // tanh(3) is about 0.995. Seems reasonable. 
-    float smooth_pitch_constant = 3.0f / smooth_offset_cycles_;
-    float pitch_h = 0.0f;
-    if (do_smooth_offset_) {
-      pitch_h = static_cast<float>(pitch_index) / cycle_samples;
+
+    // Samples are copied from input to output up to the pitch cutoff, or
+    // the end of the input buffer, and the remainder of the SSI is zero.
+    // The gather indices increase along the SSI, so the cutoff can be found
+    // by binary search.
+    int count = gather_count_[ch];
+    if (!do_smooth_offset_) {
+      count = std::lower_bound(index, index + count, cutoff_index) - index;
     }
-    
-    // Copy the buffer from input to output, addressing by h-value.
-    for (int i = 0; i < ssi_width_samples_; ++i) {
-      
-      // The index into the input array is a floating-point number, which is
-      // split into a whole part and a fractional part. The whole part and
-      // fractional part are found, and are used to linearly interpolate
-      // between input samples to yield an output sample.
-      double whole_part;
-      float frac_part = modf(h_[i] * cycle_samples, &whole_part);
-      int sample = floor(whole_part);
 
-      float weight = channel_weight;
-      
-      if (do_smooth_offset_ && do_pitch_cutoff_) {
-        // Smoothing around the pitch cutoff line.
-        float pitch_weight = (1.0f + tanh((pitch_h - h_[i])
-                                          * smooth_pitch_constant)) / 2.0f;
-        weight *= pitch_weight;
-        //LOG_INFO("Channel %d, Sample %d. Pitch weight: %f", ch, i, pitch_weight);
+    if (do_smooth_offset_ && do_pitch_cutoff_) {
+      // Smoothing around the pitch cutoff line.
+      float pitch_h = static_cast<float>(pitch_index) / cycle_samples_[ch];
+      for (int i = 0; i < count; ++i) {
+        float weight = channel_weight
+                       * PitchRamp((pitch_h - h_[i]) * smooth_pitch_constant)
+                       * channel_scaling_[ch];
+        float curr_sample = sig[index[i]] * scale;
+        float next_sample = sig[index[i] + 1] * scale;
+        out[i] = weight * (curr_sample
+                           + fraction[i] * (next_sample - curr_sample));
+      }
+    } else {
+      float weight = channel_weight * channel_scaling_[ch];
+      for (int i = 0; i < count; ++i) {
+        float curr_sample = sig[index[i]] * scale;
+        float next_sample = sig[index[i] + 1] * scale;
+        out[i] = weight * (curr_sample
+                           + fraction[i] * (next_sample - curr_sample));
+      }
+    }
+    for (int i = count; i < ssi_width_samples_; ++i) {
+      out[i] = 0.0f;
+    }
+    if (profiles_only)
+      AccumulateProfiles(ch);
+  }
+
+  if (profiles_only) {
+    for (unsigned int p = 0; p < profile_targets_.size(); ++p) {
+      profiles_[p]->set_start_time(input.start_time());
+      profiles_[p]->set_pitch_index(output_.pitch_index());
+      profile_targets_[p]->ProcessProfile(*profiles_[p]);
+    }
+  } else {
+    PushOutput();
+  }
+}
+
+void ModuleSSI::SetUpProfiles() {
+  profile_targets_.clear();
+  profile_requests_.clear();
+  profiles_.clear();
+  set<Module*>::const_iterator it;
+  for (it = targets_.begin(); it != targets_.end(); ++it) {
+    ProfileRequest request;
+    if (!(*it)->GetProfileRequest(&request))
+      continue;
+    profile_targets_.push_back(*it);
+    profile_requests_.push_back(request);
+    SignalBank *profile = new SignalBank;
+    if (request.temporal) {
+      profile->Initialize(1, ssi_width_samples_, sample_rate_);
+    } else {
+      profile->Initialize(channel_count_, 1, sample_rate_);
+      for (int ch = 0; ch < channel_count_; ++ch) {
+        profile->set_centre_frequency(ch, output_.centre_frequency(ch));
       }
+    }
+    profiles_.push_back(linked_ptr<SignalBank>(profile));
+  }
+}
 
-      if (weight_by_scaling_) {
-        if (centre_frequency > pivot_cf_) {
-          weight *= (centre_frequency / pivot_cf_);
+void ModuleSSI::PrepareProfiles() {
+  // The profile banks are only set up again if targets have been added
+  // since initialization
+  if (profile_targets_.size() != targets_.size()
+      || !std::equal(profile_targets_.begin(), profile_targets_.end(),
+                     targets_.begin())) {
+    SetUpProfiles();
+  }
+
+  // The targets only settle their ranges when they are initialized, which
+  // happens after this module is, so the requests are read every time.
+  for (unsigned int p = 0; p < profile_targets_.size(); ++p) {
+    profile_targets_[p]->GetProfileRequest(&profile_requests_[p]);
+    profiles_[p]->Clear();
+  }
+}
+
+void ModuleSSI::AccumulateProfiles(int channel) {
+  for (unsigned int p = 0; p < profile_targets_.size(); ++p) {
+    const ProfileRequest &request = profile_requests_[p];
+    if (request.temporal) {
+      if (channel >= request.lower_index && channel < request.upper_index) {
+        float *profile = &profiles_[p]->get_mutable_signal(0)[0];
+        for (int i = 0; i < ssi_width_samples_; ++i) {
+          profile[i] += profile_row_[i];
         }
       }
-
-      float val;
-      if (sample < cutoff_index || do_smooth_offset_) {
-        float curr_sample = input.sample(ch, sample);
-        float next_sample = input.sample(ch, sample + 1);
-        val = weight * (curr_sample
-                        + frac_part * (next_sample - curr_sample));
-      } else {
-        val = 0.0f;
+    } else {
+      float value = 0.0f;
+      for (int i = request.lower_index; i < request.upper_index; ++i) {
+        value += profile_row_[i];
       }
-      output_.set_sample(ch, i, val);
+      profiles_[p]->set_sample(channel, 0, value);
     }
   }
-  PushOutput();
 }
 }  // namespace aimc
 
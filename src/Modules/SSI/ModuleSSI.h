@@ -26,6 +26,7 @@
 
 #include <vector>
 #include "Support/Module.h"
+#include "Support/linked_ptr.h"
 
 namespace aimc {
 using std::vector;
@@ -38,6 +39,12 @@ class ModuleSSI : public Module {
    */
   virtual void Process(const SignalBank &input);
 
+  /*! \brief Process an SAI given as a buffer and a scale factor, as passed
+   *  on by the SAI module
+   */
+  virtual bool AcceptsScaledInput() const;
+  virtual void ProcessScaled(const SignalBank &input, float scale);
+
  private:
   /*! \brief Reset the internal state of the module
    */
@@ -49,7 +56,35 @@ class ModuleSSI : public Module {
    */
   virtual bool InitializeInternal(const SignalBank &input);
 
-  int ExtractPitchIndex(const SignalBank &input) const;
+  /*! \brief Find the pitch of the input SAI, as the lag of the largest peak
+   *  in its temporal profile after ssi.pitch_search_start_ms
+   *  \param scale Factor by which the values of input are multiplied
+   */
+  int ExtractPitchIndex(const SignalBank &input, float scale);
+
+  /*! \brief Set the length of the input buffer, and update the tables which
+   *  depend on it
+   */
+  void SetBufferLength(int buffer_length);
+
+  /*! \brief Return (1 + tanh(x)) / 2, interpolated from a table
+   */
+  float PitchRamp(float x) const;
+
+  /*! \brief Collect the profile requests of the targets, and set up a
+   *  profile SignalBank for each one
+   */
+  void SetUpProfiles();
+
+  /*! \brief Update the profile requests of the targets, and clear the
+   *  profiles, before each frame
+   */
+  void PrepareProfiles();
+
+  /*! \brief Add one channel of the SSI, from profile_row_, to each of the
+   *  profiles
+   */
+  void AccumulateProfiles(int channel);
 
   float sample_rate_;
   int buffer_length_;
@@ -66,6 +101,49 @@ class ModuleSSI : public Module {
   float pitch_search_start_ms_;
   bool do_smooth_offset_;
   float smooth_offset_cycles_;
+
+  /*! \brief Index of the input sample from which each SSI sample is
+   *  interpolated, for each channel in turn
+   */
+  vector<int> gather_index_;
+
+  /*! \brief Fractional part of the input position of each SSI sample, for
+   *  each channel in turn
+   */
+  vector<float> gather_fraction_;
+
+  /*! \brief Number of SSI samples in each channel which lie within the
+   *  input buffer
+   */
+  vector<int> gather_count_;
+
+  /*! \brief Weight applied to each channel when weighting by scaling
+   */
+  vector<float> channel_scaling_;
+
+  /*! \brief Length of a cycle of each channel's centre frequency, in samples
+   */
+  vector<float> cycle_samples_;
+
+  /*! \brief Table of the smooth pitch offset ramp
+   */
+  vector<float> pitch_ramp_;
+
+  /*! \brief Scratch space for a single channel of the SSI, used when the
+   *  targets only need profiles of the SSI
+   */
+  vector<float> profile_row_;
+
+  /*! \brief Temporal profile of the SAI, used for finding the pitch
+   */
+  vector<float> sai_temporal_profile_;
+
+  /*! \brief Targets which only use profiles of the SSI, the profiles which
+   *  they use, and the profiles themselves
+   */
+  vector<Module*> profile_targets_;
+  vector<ProfileRequest> profile_requests_;
+  vector<linked_ptr<SignalBank> > profiles_;
 };
 }  // namespace aimc
 
@@ -78,14 +78,15 @@ void ModuleLocalMax::Process(const SignalBank &input) {
     return;
   }
 
-  // Check that ths input this time is the same as the input passed to
-  // Initialize()
-  if (buffer_length_ != input.buffer_length()
-      || channel_count_ != input.channel_count()) {
+  // Check that the input this time has the same channels as the input passed
+  // to Initialize(). The buffer length may vary.
+  if (channel_count_ != input.channel_count()) {
     LOG_ERROR(_T("Mismatch between input to Initialize() and input to "
                  "Process() in module %s."), module_identifier_.c_str());
     return;
   }
+  buffer_length_ = input.buffer_length();
+  output_.SetBufferLength(buffer_length_);
 
   for (int ch = 0; ch < output_.channel_count(); ch++) {
     output_.ResetStrobes(ch);
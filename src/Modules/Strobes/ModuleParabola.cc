@@ -96,6 +96,7 @@ void ModuleParabola::Process(const SignalBank &input) {
     output_.ResetStrobes(ch);
   }
   output_.set_start_time(input.start_time());
+  output_.SetBufferLength(input.buffer_length());
 
   // Loop across samples first, then channels
   for (int i = 0; i < input.buffer_length(); i++) {
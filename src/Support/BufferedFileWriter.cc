@@ -0,0 +1,210 @@
+// Copyright 2026, agent
+//
+// AIM-C: A C++ implementation of the Auditory Image Model
+// http://www.acousticscale.org/AIMC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*! \author agent <agent@local>
+ *  \date 2026/10/19
+ *  \version \$Id$
+ */
+
+#include <string.h>
+
+#include "Support/BufferedFileWriter.h"
+
+namespace aimc {
+// Number of full buffers which may be waiting for the background thread
+// before the caller is made to wait
+static const int kBackgroundQueueLength = 4;
+
+/*! \brief A block of the file, written by the background thread
+ */
+class BufferedFileWriter::WriteJob : public WriterThread::Job {
+ public:
+  WriteJob(FILE *file, bool flush, bool *failed) : size_(0), file_(file),
+                                                   flush_(flush),
+                                                   failed_(failed) {
+  }
+
+  virtual void Write() {
+    if (size_ > 0 && fwrite(&data_[0], 1, size_, file_) != size_) {
+      *failed_ = true;
+    }
+    if (flush_ && fflush(file_) != 0) {
+      *failed_ = true;
+    }
+  }
+
+  vector<char> data_;
+  size_t size_;
+
+ private:
+  FILE *file_;
+  bool flush_;
+  bool *failed_;
+};
+
+BufferedFileWriter::BufferedFileWriter(size_t buffer_size)
+    : file_(NULL),
+      owns_file_(true),
+      used_(0),
+      failed_(false),
+      writer_thread_(NULL) {
+  SetBufferSize(buffer_size);
+}
+
+BufferedFileWriter::~BufferedFileWriter() {
+  Close();
+  SetBackgroundWrite(false);
+}
+
+void BufferedFileWriter::SetBufferSize(size_t buffer_size) {
+  Flush();
+  if (buffer_size < 1) {
+    buffer_size = 1;
+  }
+  buffer_.resize(buffer_size);
+}
+
+void BufferedFileWriter::SetBackgroundWrite(bool background) {
+  if (background && writer_thread_ == NULL) {
+    writer_thread_ = new WriterThread(kBackgroundQueueLength);
+  } else if (!background && writer_thread_ != NULL) {
+    Flush();
+    Sync();
+    delete writer_thread_;
+    writer_thread_ = NULL;
+  }
+}
+
+bool BufferedFileWriter::Open(const string &filename) {
+  Close();
+  file_ = fopen(filename.c_str(), "wb");
+  if (file_ == NULL) {
+    return false;
+  }
+  // All writes are already batched in buffer_
+  setvbuf(file_, NULL, _IONBF, 0);
+  owns_file_ = true;
+  used_ = 0;
+  failed_ = false;
+  return true;
+}
+
+bool BufferedFileWriter::OpenStandardOutput() {
+  Close();
+  // stdout keeps its own stdio buffer, as other output may share it, so it
+  // is flushed after every write instead
+  file_ = stdout;
+  owns_file_ = false;
+  used_ = 0;
+  failed_ = false;
+  return true;
+}
+
+bool BufferedFileWriter::Close() {
+  if (file_ == NULL) {
+    return false;
+  }
+  Flush();
+  Sync();
+  if (owns_file_ && fclose(file_) != 0) {
+    failed_ = true;
+  }
+  file_ = NULL;
+  return !failed_;
+}
+
+void BufferedFileWriter::Write(const void *data, size_t size) {
+  if (used_ + size > buffer_.size()) {
+    Flush();
+    // Blocks at least as big as the buffer gain nothing from the copy
+    if (size >= buffer_.size()) {
+      WriteBlock(data, size);
+      return;
+    }
+  }
+  memcpy(&buffer_[used_], data, size);
+  used_ += size;
+}
+
+char *BufferedFileWriter::Reserve(size_t size) {
+  if (used_ + size > buffer_.size()) {
+    Flush();
+    if (size > buffer_.size()) {
+      buffer_.resize(size);
+    }
+  }
+  char *space = &buffer_[0] + used_;
+  used_ += size;
+  return space;
+}
+
+bool BufferedFileWriter::Overwrite(long offset, const void *data,
+                                   size_t size) {
+  if (file_ == NULL) {
+    return false;
+  }
+  Flush();
+  Sync();
+  bool ok = (fseek(file_, offset, SEEK_SET) == 0
+             && fwrite(data, 1, size, file_) == size);
+  if (fseek(file_, 0, SEEK_END) != 0 || !ok) {
+    failed_ = true;
+    return false;
+  }
+  return true;
+}
+
+void BufferedFileWriter::Flush() {
+  if (used_ > 0 && file_ != NULL) {
+    if (writer_thread_ != NULL) {
+      // Hand over the whole buffer rather than copying it
+      WriteJob *job = new WriteJob(file_, !owns_file_, &failed_);
+      size_t buffer_size = buffer_.size();
+      job->data_.swap(buffer_);
+      job->size_ = used_;
+      buffer_.resize(buffer_size);
+      writer_thread_->Enqueue(job);
+    } else if (fwrite(&buffer_[0], 1, used_, file_) != used_
+               || (!owns_file_ && fflush(file_) != 0)) {
+      failed_ = true;
+    }
+  }
+  used_ = 0;
+}
+
+void BufferedFileWriter::Sync() {
+  if (writer_thread_ != NULL) {
+    writer_thread_->WaitUntilIdle();
+  }
+}
+
+void BufferedFileWriter::WriteBlock(const void *data, size_t size) {
+  if (file_ == NULL) {
+    return;
+  }
+  if (writer_thread_ != NULL) {
+    WriteJob *job = new WriteJob(file_, !owns_file_, &failed_);
+    job->data_.assign(reinterpret_cast<const char*>(data),
+                      reinterpret_cast<const char*>(data) + size);
+    job->size_ = size;
+    writer_thread_->Enqueue(job);
+  } else if (fwrite(data, 1, size, file_) != size
+             || (!owns_file_ && fflush(file_) != 0)) {
+    failed_ = true;
+  }
+}
+}  // namespace aimc
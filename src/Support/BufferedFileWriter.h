@@ -0,0 +1,145 @@
+// Copyright 2026, agent
+//
+// AIM-C: A C++ implementation of the Auditory Image Model
+// http://www.acousticscale.org/AIMC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*! \file
+ *  \brief Output file with a single large staging buffer
+ */
+
+/*! \author agent <agent@local>
+ *  \date 2026/10/19
+ *  \version \$Id$
+ */
+
+#ifndef AIMC_SUPPORT_BUFFEREDFILEWRITER_H_
+#define AIMC_SUPPORT_BUFFEREDFILEWRITER_H_
+
+#include <stddef.h>
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#include "Support/Common.h"
+#include "Support/WriterThread.h"
+
+namespace aimc {
+using std::string;
+using std::vector;
+
+/*! \brief Writes a file through a staging buffer, which goes to the
+ *  operating system in a single write whenever it fills up.
+ *
+ * stdio's own buffering is turned off, so each call to Write() or Reserve()
+ * costs no more than a copy, and there is one system call per buffer of
+ * output however small the individual records are. Overwrite() is for
+ * headers which can only be filled in once the rest of the file has been
+ * written.
+ *
+ * With background writing enabled, full buffers are passed to a
+ * WriterThread instead of being written by the caller. Overwrite() and
+ * Close() wait for the queued buffers to reach the file first.
+ */
+class BufferedFileWriter {
+ public:
+  /*! \param buffer_size Size of the staging buffer in bytes
+   */
+  explicit BufferedFileWriter(size_t buffer_size);
+  ~BufferedFileWriter();
+
+  /*! \brief Change the size of the staging buffer, flushing it first
+   */
+  void SetBufferSize(size_t buffer_size);
+
+  /*! \brief Write full buffers on a background thread rather than in the
+   *  calling thread
+   */
+  void SetBackgroundWrite(bool background);
+
+  /*! \brief Create or truncate a file for writing. Any file already open is
+   *  closed first.
+   *  \return true on success, false if the file couldn't be opened.
+   */
+  bool Open(const string &filename);
+
+  /*! \brief Write to stdout instead of a file. Each flushed buffer is
+   *  passed straight on, so that another process reading the output sees
+   *  it as soon as it is flushed. Any file already open is closed first.
+   */
+  bool OpenStandardOutput();
+
+  /*! \brief Flush the buffer and close the file. stdout is flushed, but
+   *  left open.
+   *  \return true if the file was open and every write to it succeeded.
+   */
+  bool Close();
+
+  /*! \brief Append size bytes to the file
+   */
+  void Write(const void *data, size_t size);
+
+  /*! \brief Append size bytes to the file, returning a pointer to the place
+   *  in the staging buffer where they should be stored. The bytes must be
+   *  filled in before the next call to any other method.
+   */
+  char *Reserve(size_t size);
+
+  /*! \brief Flush the buffer, then replace size bytes of the file starting
+   *  at offset. Later writes still go to the end of the file.
+   */
+  bool Overwrite(long offset, const void *data, size_t size);
+
+  /*! \brief Pass the contents of the staging buffer to the operating
+   *  system, or to the background thread
+   */
+  void Flush();
+
+  /*! \brief Wait for all flushed data to be written
+   */
+  void Sync();
+
+  bool is_open() const {
+    return file_ != NULL;
+  }
+
+ private:
+  class WriteJob;
+
+  /*! \brief Write a block to the file, in order after anything already
+   *  flushed
+   */
+  void WriteBlock(const void *data, size_t size);
+
+  FILE *file_;
+  /*! \brief false when writing to stdout
+   */
+  bool owns_file_;
+  vector<char> buffer_;
+  size_t used_;
+
+  /*! \brief Set when any write fails, and reported by Close(). Only
+   *  accessed by the background thread while buffers are queued.
+   */
+  bool failed_;
+
+  /*! \brief NULL unless background writing is enabled
+   */
+  WriterThread *writer_thread_;
+  DISALLOW_COPY_AND_ASSIGN(BufferedFileWriter);
+};
+}  // namespace aimc
+
+#endif  // AIMC_SUPPORT_BUFFEREDFILEWRITER_H_
@@ -0,0 +1,109 @@
+// Copyright 2026, agent
+//
+// AIM-C: A C++ implementation of the Auditory Image Model
+// http://www.acousticscale.org/AIMC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*! \file
+ *  \brief Simple in-place radix-2 complex FFT
+ */
+
+/*! \author agent <agent@local>
+ *  \date 2026/10/19
+ *  \version \$Id$
+ */
+
+#include <cmath>
+
+#include "Support/Common.h"
+#include "Support/FFT.h"
+
+namespace aimc {
+FFT::FFT() {
+  size_ = 0;
+}
+
+FFT::~FFT() {
+}
+
+int FFT::NextPowerOfTwo(int n) {
+  int size = 1;
+  while (size < n)
+    size *= 2;
+  return size;
+}
+
+bool FFT::Initialize(int size) {
+  if (size < 1 || (size & (size - 1)) != 0) {
+    LOG_ERROR(_T("FFT size %d is not a power of two"), size);
+    return false;
+  }
+  size_ = size;
+
+  int bits = 0;
+  while ((1 << bits) < size_)
+    ++bits;
+  bit_reverse_.resize(size_);
+  for (int i = 0; i < size_; ++i) {
+    int reversed = 0;
+    for (int b = 0; b < bits; ++b) {
+      if (i & (1 << b))
+        reversed |= 1 << (bits - 1 - b);
+    }
+    bit_reverse_[i] = reversed;
+  }
+
+  // Twiddle factors for the largest butterfly. Smaller butterflies use
+  // every n-th one.
+  twiddles_.resize(size_ / 2 > 0 ? size_ / 2 : 1);
+  for (int i = 0; i < size_ / 2; ++i) {
+    double phase = -2.0 * M_PI * i / size_;
+    twiddles_[i] = complex<float>(cos(phase), sin(phase));
+  }
+  return true;
+}
+
+void FFT::Transform(vector<complex<float> > *data, bool inverse) const {
+  vector<complex<float> > &x = *data;
+  for (int i = 0; i < size_; ++i) {
+    int j = bit_reverse_[i];
+    if (j > i) {
+      complex<float> tmp = x[i];
+      x[i] = x[j];
+      x[j] = tmp;
+    }
+  }
+
+  for (int length = 2; length <= size_; length *= 2) {
+    int half = length / 2;
+    int stride = size_ / length;
+    for (int start = 0; start < size_; start += length) {
+      for (int k = 0; k < half; ++k) {
+        complex<float> w = twiddles_[k * stride];
+        if (inverse)
+          w = conj(w);
+        complex<float> t = w * x[start + k + half];
+        x[start + k + half] = x[start + k] - t;
+        x[start + k] += t;
+      }
+    }
+  }
+
+  if (inverse) {
+    float scale = 1.0f / size_;
+    for (int i = 0; i < size_; ++i)
+      x[i] *= scale;
+  }
+}
+}  // namespace aimc
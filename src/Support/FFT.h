@@ -0,0 +1,76 @@
+// Copyright 2026, agent
+//
+// AIM-C: A C++ implementation of the Auditory Image Model
+// http://www.acousticscale.org/AIMC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*! \file
+ *  \brief Simple in-place radix-2 complex FFT
+ */
+
+/*! \author agent <agent@local>
+ *  \date 2026/10/19
+ *  \version \$Id$
+ */
+
+#ifndef AIMC_SUPPORT_FFT_H_
+#define AIMC_SUPPORT_FFT_H_
+
+#include <complex>
+#include <vector>
+
+namespace aimc {
+using std::complex;
+using std::vector;
+
+/*! \brief In-place radix-2 complex FFT of a fixed size.
+ *
+ * The twiddle factors and bit-reversal permutation are computed once in
+ * Initialize(), so that repeated transforms of the same size are cheap.
+ * Two real signals of the same length can be transformed at once by
+ * packing them into the real and imaginary parts of the input.
+ */
+class FFT {
+ public:
+  FFT();
+  ~FFT();
+
+  /*! \brief Prepare for transforms of the given size
+   *  \param size Transform length. Must be a power of two.
+   *  \return true on success, false on failure.
+   */
+  bool Initialize(int size);
+
+  /*! \brief Transform data in place. The inverse transform is scaled by
+   *  1/size, so that a forward transform followed by an inverse transform
+   *  returns the original data.
+   */
+  void Transform(vector<complex<float> > *data, bool inverse) const;
+
+  int size() const {
+    return size_;
+  }
+
+  /*! \brief Return the smallest power of two which is at least n
+   */
+  static int NextPowerOfTwo(int n);
+
+ private:
+  int size_;
+  vector<int> bit_reverse_;
+  vector<complex<float> > twiddles_;
+};
+}  // namespace aimc
+
+#endif  // AIMC_SUPPORT_FFT_H_
@@ -0,0 +1,190 @@
+// Copyright 2026, agent
+//
+// AIM-C: A C++ implementation of the Auditory Image Model
+// http://www.acousticscale.org/AIMC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*! \author agent <agent@local>
+ *  \date 2026/10/19
+ *  \version \$Id$
+ */
+
+#include <stdio.h>
+
+#include <fstream>
+
+#include "Support/FeatureArchive.h"
+
+namespace aimc {
+using std::ifstream;
+
+FeatureArchive::FeatureArchive() {
+}
+
+FeatureArchive::~FeatureArchive() {
+  Close();
+}
+
+string FeatureArchive::IndexFilename(const string &path) {
+  return path + ".index";
+}
+
+string FeatureArchive::ShardFilename(const string &path, int shard) {
+  char suffix[32];
+  snprintf(suffix, sizeof(suffix), ".%05d.shard", shard);
+  return path + suffix;
+}
+
+bool FeatureArchive::Open(const string &path) {
+  Close();
+  string index_filename = IndexFilename(path);
+  ifstream index(index_filename.c_str());
+  if (index.fail()) {
+    LOG_ERROR(_T("Couldn't open archive index '%s' for reading."),
+              index_filename.c_str());
+    return false;
+  }
+
+  string line;
+  if (!getline(index, line) || line.compare(kFeatureArchiveHeader) != 0) {
+    LOG_ERROR(_T("'%s' is not a feature archive index."),
+              index_filename.c_str());
+    return false;
+  }
+  path_ = path;
+  // Size of each shard, or -1 until it is first needed
+  vector<long long> shard_sizes;
+  int line_number = 1;
+  while (getline(index, line)) {
+    ++line_number;
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    ArchiveUtterance utterance;
+    if (!ParseIndexLine(line, &utterance)) {
+      LOG_ERROR(_T("Bad entry on line %d of archive index '%s'."),
+                line_number, index_filename.c_str());
+      Close();
+      return false;
+    }
+
+    // Shards are only mapped by Frames(), but every utterance is checked
+    // against the size of its shard here. Utterances with no frames don't
+    // need their shard at all, and it may be empty.
+    long long size = static_cast<long long>(utterance.frame_count)
+                     * utterance.channel_count * utterance.sample_count
+                     * sizeof(float);
+    if (size > 0) {
+      if (static_cast<int>(shard_sizes.size()) <= utterance.shard) {
+        shard_sizes.resize(utterance.shard + 1, -1);
+      }
+      if (shard_sizes[utterance.shard] < 0) {
+        string shard_filename = ShardFilename(path, utterance.shard);
+        shard_sizes[utterance.shard] = MappedFile::FileSize(shard_filename);
+        if (shard_sizes[utterance.shard] < 0) {
+          LOG_ERROR(_T("Couldn't find archive shard '%s'."),
+                    shard_filename.c_str());
+          Close();
+          return false;
+        }
+      }
+      if (utterance.offset + size > shard_sizes[utterance.shard]) {
+        LOG_ERROR(_T("Utterance '%s' runs past the end of its archive "
+                     "shard."), utterance.id.c_str());
+        Close();
+        return false;
+      }
+    }
+    // Later entries for the same id take precedence
+    ids_[utterance.id] = utterances_.size();
+    utterances_.push_back(utterance);
+  }
+  shards_.resize(shard_sizes.size(), NULL);
+  return true;
+}
+
+bool FeatureArchive::ParseIndexLine(const string &line,
+                                    ArchiveUtterance *utterance) {
+  size_t tab = line.find('\t');
+  if (tab == string::npos || tab == 0) {
+    return false;
+  }
+  utterance->id = line.substr(0, tab);
+  int fields = sscanf(line.c_str() + tab + 1, "%d %lld %d %d %d %f %f",
+                      &utterance->shard, &utterance->offset,
+                      &utterance->frame_count, &utterance->channel_count,
+                      &utterance->sample_count, &utterance->frame_period_ms,
+                      &utterance->sample_rate);
+  return (fields == 7 && utterance->shard >= 0 && utterance->offset >= 0
+          && utterance->offset % sizeof(float) == 0
+          && utterance->frame_count >= 0 && utterance->channel_count >= 0
+          && utterance->sample_count >= 0);
+}
+
+void FeatureArchive::Close() {
+  for (unsigned int i = 0; i < shards_.size(); ++i) {
+    delete shards_[i];
+  }
+  shards_.clear();
+  path_.clear();
+  utterances_.clear();
+  ids_.clear();
+}
+
+int FeatureArchive::Find(const string &id) const {
+  map<string, int>::const_iterator it = ids_.find(id);
+  if (it == ids_.end()) {
+    return -1;
+  }
+  return it->second;
+}
+
+const float *FeatureArchive::Frames(int index) const {
+  const ArchiveUtterance &entry = utterances_[index];
+  if (static_cast<long long>(entry.frame_count) * entry.channel_count
+      * entry.sample_count == 0) {
+    return NULL;
+  }
+  // Map the shard on first use
+  if (shards_[entry.shard] == NULL) {
+    string shard_filename = ShardFilename(path_, entry.shard);
+    MappedFile *shard = new MappedFile();
+    // Open() checked the utterance against the size of the shard, but the
+    // file may have changed since
+    if (!shard->Open(shard_filename, false)
+        || static_cast<long long>(shard->size())
+           < entry.offset + static_cast<long long>(entry.frame_count)
+             * entry.channel_count * entry.sample_count
+             * static_cast<long long>(sizeof(float))) {
+      LOG_ERROR(_T("Couldn't map archive shard '%s'."),
+                shard_filename.c_str());
+      delete shard;
+      return NULL;
+    }
+    shards_[entry.shard] = shard;
+  }
+  return reinterpret_cast<const float*>(shards_[entry.shard]->data()
+                                        + entry.offset);
+}
+
+vector<float> FeatureArchive::GetFrames(int index) const {
+  const ArchiveUtterance &entry = utterances_[index];
+  const float *frames = Frames(index);
+  if (frames == NULL) {
+    return vector<float>();
+  }
+  return vector<float>(frames, frames + entry.frame_count
+                               * entry.channel_count * entry.sample_count);
+}
+}  // namespace aimc
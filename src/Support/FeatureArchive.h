@@ -0,0 +1,135 @@
+// Copyright 2026, agent
+//
+// AIM-C: A C++ implementation of the Auditory Image Model
+// http://www.acousticscale.org/AIMC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*! \file
+ *  \brief Reader for archives of features from many utterances
+ *
+ * An archive with path P is made up of an index, P.index, and one or more
+ * shards, P.00000.shard, P.00001.shard and so on. The shards hold nothing
+ * but frames of 32-bit floats in the byte order of the machine which wrote
+ * them, one utterance after another. Within an utterance the values are
+ * stored by frame, then channel, then sample, so that every frame is a
+ * contiguous block of channels * samples floats.
+ *
+ * The index is a text file. Its first line is kFeatureArchiveHeader, and
+ * every following line describes one utterance with the tab-separated
+ * fields
+ *   id shard offset frames channels samples frame_period_ms sample_rate
+ * where offset is the position of the utterance's first frame in the shard
+ * in bytes. Lines starting with '#' are comments.
+ */
+
+/*! \author agent <agent@local>
+ *  \date 2026/10/19
+ *  \version \$Id$
+ */
+
+#ifndef AIMC_SUPPORT_FEATUREARCHIVE_H_
+#define AIMC_SUPPORT_FEATUREARCHIVE_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Support/Common.h"
+#include "Support/MappedFile.h"
+
+namespace aimc {
+using std::map;
+using std::string;
+using std::vector;
+
+/*! \brief First line of every archive index
+ */
+const char kFeatureArchiveHeader[] = "# AIM-C feature archive 1";
+
+/*! \brief Index entry for one utterance in a FeatureArchive
+ */
+struct ArchiveUtterance {
+  string id;
+  int shard;
+  long long offset;
+  int frame_count;
+  int channel_count;
+  int sample_count;
+  float frame_period_ms;
+  float sample_rate;
+};
+
+/*! \brief Gives access to every utterance in a feature archive, with the
+ *  shards memory-mapped so that only the frames which are used are read.
+ */
+class FeatureArchive {
+ public:
+  FeatureArchive();
+  ~FeatureArchive();
+
+  /*! \brief Read the index of the archive with the given path, and check
+   *  it against the sizes of the shards. The shards aren't mapped until
+   *  their frames are first asked for. Any archive already open is closed
+   *  first.
+   *  \return true on success, false if the archive couldn't be read or
+   *  is inconsistent.
+   */
+  bool Open(const string &path);
+  void Close();
+
+  int utterance_count() const {
+    return utterances_.size();
+  }
+
+  const ArchiveUtterance &utterance(int index) const {
+    return utterances_[index];
+  }
+
+  /*! \brief Return the index of the utterance with the given id, or -1 if
+   *  there is none
+   */
+  int Find(const string &id) const;
+
+  /*! \brief Return the frames of an utterance, in place in the mapped
+   *  shard, or NULL if the utterance has no frames or its shard can't be
+   *  mapped. The shard is mapped on the first call for any of its
+   *  utterances, so calls from several threads at once aren't safe.
+   */
+  const float *Frames(int index) const;
+
+  /*! \brief Return a copy of the frames of an utterance
+   */
+  vector<float> GetFrames(int index) const;
+
+  static string IndexFilename(const string &path);
+  static string ShardFilename(const string &path, int shard);
+
+ private:
+  /*! \brief Parse one line of the index.
+   *  \return false if the line is malformed.
+   */
+  bool ParseIndexLine(const string &line, ArchiveUtterance *utterance);
+
+  string path_;
+  vector<ArchiveUtterance> utterances_;
+  map<string, int> ids_;
+  /*! \brief Indexed by shard number. Shards which haven't been used yet
+   *  are NULL.
+   */
+  mutable vector<MappedFile*> shards_;
+  DISALLOW_COPY_AND_ASSIGN(FeatureArchive);
+};
+}  // namespace aimc
+
+#endif  // AIMC_SUPPORT_FEATUREARCHIVE_H_
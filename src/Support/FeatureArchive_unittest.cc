@@ -0,0 +1,171 @@
+// Copyright 2026, agent
+//
+// AIM-C: A C++ implementation of the Auditory Image Model
+// http://www.acousticscale.org/AIMC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*!
+ * \author agent <agent@local>
+ * \date created 2026/10/19
+ * \version \$Id$
+ */
+
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Modules/Output/FileOutputArchive.h"
+#include "Support/FeatureArchive.h"
+#include "Support/Parameters.h"
+#include "Support/SignalBank.h"
+
+namespace aimc {
+using std::string;
+using std::vector;
+
+static const char kPath[] = "FeatureArchive_unittest_archive";
+static const int kChannels = 3;
+static const int kSamples = 4;
+static const int kFramePeriod = 160;
+static const float kSampleRate = 16000.0f;
+
+// Utterances written to the archive, and their lengths in frames
+static const char *kIds[] = { "utt_a", "utt_b", "utt_c" };
+static const int kFrameCounts[] = { 5, 3, 7 };
+static const int kUtterances = 3;
+
+static float Value(int utterance, int frame, int ch, int i) {
+  return 1000.0f * utterance + 100.0f * frame + 10.0f * ch + i;
+}
+
+// Return the size of a file, or -1 if it can't be opened
+static long FileSize(const string &filename) {
+  FILE *file = fopen(filename.c_str(), "rb");
+  if (file == NULL) {
+    return -1;
+  }
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  fclose(file);
+  return size;
+}
+
+// Cut a file down to the given size
+static void Truncate(const string &filename, long size) {
+  FILE *file = fopen(filename.c_str(), "rb");
+  ASSERT_TRUE(file != NULL);
+  vector<char> contents(size);
+  ASSERT_EQ(static_cast<size_t>(size),
+            fread(&contents[0], 1, size, file));
+  fclose(file);
+  file = fopen(filename.c_str(), "wb");
+  ASSERT_TRUE(file != NULL);
+  fwrite(&contents[0], 1, size, file);
+  fclose(file);
+}
+
+class FeatureArchiveTest : public ::testing::Test {
+ protected:
+  // Write the utterances with archive_out, starting a new shard for each
+  virtual void SetUp() {
+    Parameters parameters;
+    parameters.SetString("archive_out.path", kPath);
+    parameters.SetInt("archive_out.shard_size_mb", 0);
+    Parameters global_parameters;
+    FileOutputArchive output(&parameters);
+    SignalBank input;
+    input.Initialize(kChannels, kSamples, kSampleRate);
+    for (int u = 0; u < kUtterances; ++u) {
+      global_parameters.SetString("output_filename_base", kIds[u]);
+      if (u == 0) {
+        ASSERT_TRUE(output.Initialize(input, &global_parameters));
+      } else {
+        output.Reset();
+      }
+      for (int frame = 0; frame < kFrameCounts[u]; ++frame) {
+        for (int ch = 0; ch < kChannels; ++ch) {
+          for (int i = 0; i < kSamples; ++i) {
+            input.set_sample(ch, i, Value(u, frame, ch, i));
+          }
+        }
+        input.set_start_time(frame * kFramePeriod);
+        output.Process(input);
+      }
+    }
+    // The last Reset() closes the archive
+    global_parameters.SetString("output_filename_base", "");
+    output.Reset();
+  }
+
+  virtual void TearDown() {
+    remove(FeatureArchive::IndexFilename(kPath).c_str());
+    for (int shard = 0; shard < kUtterances; ++shard) {
+      remove(FeatureArchive::ShardFilename(kPath, shard).c_str());
+    }
+  }
+};
+
+TEST_F(FeatureArchiveTest, ReadsBackEveryUtterance) {
+  FeatureArchive archive;
+  ASSERT_TRUE(archive.Open(kPath));
+  ASSERT_EQ(kUtterances, archive.utterance_count());
+  EXPECT_EQ(-1, archive.Find("utt_d"));
+  for (int u = 0; u < kUtterances; ++u) {
+    int index = archive.Find(kIds[u]);
+    ASSERT_EQ(u, index);
+    const ArchiveUtterance &entry = archive.utterance(index);
+    EXPECT_EQ(u, entry.shard);
+    EXPECT_EQ(0, entry.offset);
+    EXPECT_EQ(kFrameCounts[u], entry.frame_count);
+    EXPECT_EQ(kChannels, entry.channel_count);
+    EXPECT_EQ(kSamples, entry.sample_count);
+    EXPECT_FLOAT_EQ(1000.0f * kFramePeriod / kSampleRate,
+                    entry.frame_period_ms);
+    EXPECT_FLOAT_EQ(kSampleRate, entry.sample_rate);
+
+    const float *frames = archive.Frames(index);
+    ASSERT_TRUE(frames != NULL);
+    for (int frame = 0; frame < kFrameCounts[u]; ++frame) {
+      for (int ch = 0; ch < kChannels; ++ch) {
+        for (int i = 0; i < kSamples; ++i) {
+          EXPECT_EQ(Value(u, frame, ch, i), *frames++);
+        }
+      }
+    }
+  }
+}
+
+TEST_F(FeatureArchiveTest, RejectsTruncatedShard) {
+  string shard_filename = FeatureArchive::ShardFilename(kPath, 1);
+  long size = FileSize(shard_filename);
+  ASSERT_EQ(kFrameCounts[1] * kChannels * kSamples
+            * static_cast<long>(sizeof(float)), size);
+  Truncate(shard_filename, size - sizeof(float));
+  FeatureArchive archive;
+  EXPECT_FALSE(archive.Open(kPath));
+  EXPECT_EQ(0, archive.utterance_count());
+}
+
+TEST_F(FeatureArchiveTest, RejectsMalformedIndexLine) {
+  FILE *index = fopen(FeatureArchive::IndexFilename(kPath).c_str(), "ab");
+  ASSERT_TRUE(index != NULL);
+  fputs("utt_d\t0\t0\tthree\t3\t4\t10\t16000\n", index);
+  fclose(index);
+  FeatureArchive archive;
+  EXPECT_FALSE(archive.Open(kPath));
+}
+}  // namespace aimc
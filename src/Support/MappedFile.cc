@@ -0,0 +1,136 @@
+// Copyright 2026, agent
+//
+// AIM-C: A C++ implementation of the Auditory Image Model
+// http://www.acousticscale.org/AIMC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*! \author agent <agent@local>
+ *  \date 2026/10/19
+ *  \version \$Id$
+ */
+
+#ifndef _WINDOWS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Support/MappedFile.h"
+
+namespace aimc {
+MappedFile::MappedFile()
+    : data_(NULL),
+      size_(0) {
+#ifdef _WINDOWS
+  file_ = INVALID_HANDLE_VALUE;
+  file_mapping_ = NULL;
+#endif
+}
+
+MappedFile::~MappedFile() {
+  Close();
+}
+
+bool MappedFile::Open(const string &filename, bool sequential) {
+  Close();
+#ifdef _WINDOWS
+  DWORD flags = sequential ? FILE_FLAG_SEQUENTIAL_SCAN
+                           : FILE_FLAG_RANDOM_ACCESS;
+  file_ = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                      OPEN_EXISTING, flags, NULL);
+  if (file_ == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file_, &size) || size.QuadPart == 0) {
+    Close();
+    return false;
+  }
+  size_ = static_cast<size_t>(size.QuadPart);
+  file_mapping_ = CreateFileMapping(file_, NULL, PAGE_READONLY, 0, 0, NULL);
+  if (file_mapping_ == NULL) {
+    Close();
+    return false;
+  }
+  data_ = reinterpret_cast<const char*>(
+      MapViewOfFile(file_mapping_, FILE_MAP_READ, 0, 0, 0));
+  if (data_ == NULL) {
+    Close();
+    return false;
+  }
+#else
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0) {
+    close(fd);
+    return false;
+  }
+  size_ = file_stat.st_size;
+  void *mapping = mmap(NULL, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping keeps the file open
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    size_ = 0;
+    return false;
+  }
+  madvise(mapping, size_, sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+  data_ = reinterpret_cast<const char*>(mapping);
+#endif
+  return true;
+}
+
+long long MappedFile::FileSize(const string &filename) {
+#ifdef _WINDOWS
+  WIN32_FILE_ATTRIBUTE_DATA attributes;
+  if (!GetFileAttributesExA(filename.c_str(), GetFileExInfoStandard,
+                            &attributes)) {
+    return -1;
+  }
+  return (static_cast<long long>(attributes.nFileSizeHigh) << 32)
+         | attributes.nFileSizeLow;
+#else
+  struct stat file_stat;
+  if (stat(filename.c_str(), &file_stat) != 0) {
+    return -1;
+  }
+  return file_stat.st_size;
+#endif
+}
+
+void MappedFile::Close() {
+#ifdef _WINDOWS
+  if (data_ != NULL) {
+    UnmapViewOfFile(data_);
+  }
+  if (file_mapping_ != NULL) {
+    CloseHandle(file_mapping_);
+    file_mapping_ = NULL;
+  }
+  if (file_ != INVALID_HANDLE_VALUE) {
+    CloseHandle(file_);
+    file_ = INVALID_HANDLE_VALUE;
+  }
+#else
+  if (data_ != NULL) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+#endif
+  data_ = NULL;
+  size_ = 0;
+}
+}  // namespace aimc
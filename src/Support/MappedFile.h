@@ -0,0 +1,83 @@
+// Copyright 2026, agent
+//
+// AIM-C: A C++ implementation of the Auditory Image Model
+// http://www.acousticscale.org/AIMC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*! \file
+ *  \brief Read-only memory mapping of a whole file
+ */
+
+/*! \author agent <agent@local>
+ *  \date 2026/10/19
+ *  \version \$Id$
+ */
+
+#ifndef AIMC_SUPPORT_MAPPEDFILE_H_
+#define AIMC_SUPPORT_MAPPEDFILE_H_
+
+#ifdef _WINDOWS
+#include <windows.h>
+#endif
+
+#include <stddef.h>
+
+#include <string>
+
+#include "Support/Common.h"
+
+namespace aimc {
+using std::string;
+
+/*! \brief Maps the whole of a file into memory for reading, using mmap()
+ *  or the Windows equivalent.
+ */
+class MappedFile {
+ public:
+  MappedFile();
+  ~MappedFile();
+
+  /*! \brief Map a file. Any file already mapped is unmapped first.
+   *  \param sequential Hint that the file will be read from start to end
+   *  \return true on success, false if the file couldn't be mapped. Empty
+   *  files can't be mapped.
+   */
+  bool Open(const string &filename, bool sequential);
+  void Close();
+
+  /*! \brief Return the size of a file in bytes without mapping it, or -1
+   *  if it doesn't exist
+   */
+  static long long FileSize(const string &filename);
+
+  const char *data() const {
+    return data_;
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+ private:
+  const char *data_;
+  size_t size_;
+#ifdef _WINDOWS
+  HANDLE file_;
+  HANDLE file_mapping_;
+#endif
+  DISALLOW_COPY_AND_ASSIGN(MappedFile);
+};
+}  // namespace aimc
+
+#endif  // AIMC_SUPPORT_MAPPEDFILE_H_
@@ -138,6 +138,43 @@ const SignalBank* Module::GetOutputBank() const {
   return &output_;
 }
 
+bool Module::GetProfileRequest(ProfileRequest *request) const {
+  return false;
+}
+
+void Module::ProcessProfile(const SignalBank &profile) {
+}
+
+bool Module::AcceptsScaledInput() const {
+  return false;
+}
+
+void Module::ProcessScaled(const SignalBank &input, float scale) {
+}
+
+bool Module::TargetsUseProfilesOnly() const {
+  if (targets_.empty())
+    return false;
+  ProfileRequest request;
+  set<Module*>::const_iterator it;
+  for (it = targets_.begin(); it != targets_.end(); ++it) {
+    if (!(*it)->GetProfileRequest(&request))
+      return false;
+  }
+  return true;
+}
+
+bool Module::TargetsAcceptScaledInput() const {
+  if (targets_.empty())
+    return false;
+  set<Module*>::const_iterator it;
+  for (it = targets_.begin(); it != targets_.end(); ++it) {
+    if (!(*it)->AcceptsScaledInput())
+      return false;
+  }
+  return true;
+}
+
 void Module::PushOutput() {
   if (output_.initialized()) {
     set<Module*>::const_iterator it;
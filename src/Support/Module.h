@@ -40,6 +40,25 @@ using std::ostream;
 using std::set;
 using std::string;
 
+/*! \brief Description of a profile of a 2D SignalBank, formed by summing
+ *  the image along one axis over a range of indices.
+ *
+ * A temporal profile sums over channels lower_index to upper_index - 1 and
+ * has one channel with the same buffer length as the image. A spectral
+ * profile sums over samples lower_index to upper_index - 1 and has the same
+ * number of channels as the image, with a buffer length of one.
+ */
+struct ProfileRequest {
+  bool temporal;
+  int lower_index;
+  int upper_index;
+  ProfileRequest() {
+    temporal = false;
+    lower_index = 0;
+    upper_index = 0;
+  }
+};
+
 /*! \brief Base class for all AIM-C modules.
  *
  * Module() is a base class, from which all AIM-C modules are derived. 
@@ -62,9 +81,18 @@ using std::string;
  * produce an output.
  * At each call to Process(input), the module takes the
  * SignalBank 'input' (which must, unless otherwise specified, have the same
- * number of channels, sample rate, buffer size and centre frequencies as the
+ * number of channels, sample rate and centre frequencies as the
  * SignalBank which was passed to Initialize()), processes it, and places the
  * output in the internal SignalBank output_.
+ * The buffer length of the input may vary from one call to the next. It is
+ * normally no more than the max_buffer_length() of the SignalBank passed to
+ * Initialize(), so that output banks sized for that maximum never need to
+ * grow; a shorter buffer holds only valid samples (for example the end of a
+ * file), with no padding. Modules which work on a stream of samples follow
+ * the length of their input, calling SignalBank::SetBufferLength() on their
+ * output. Modules whose output has a fixed size per frame, such as feature
+ * extractors and file formats with fixed-size records, only process buffers
+ * of the length given to Initialize().
  * Modules can have an arbitrary number of unique targets. Each
  * completed output frame is 'pushed' to all of the targets of the module
  * in turn when PushOutput() is called. To achieve this, after each complete
@@ -153,6 +181,48 @@ class Module {
    */
   virtual void Process(const SignalBank &input) = 0;
 
+  /*! \brief Report whether this module only uses a profile of its input.
+   *  \param request Filled in with the profile which is used.
+   *  \return true if the module only needs the profile, false if it needs
+   *  the complete input.
+   *
+   * A module whose input is expensive to generate in full may call
+   * ProcessProfile() on such targets in place of Process(), and so avoid
+   * building the whole output SignalBank. The default implementation
+   * returns false.
+   */
+  virtual bool GetProfileRequest(ProfileRequest *request) const;
+
+  /*! \brief Process a precomputed profile of the input.
+   *  \param profile The profile described by GetProfileRequest(), computed
+   *  from an input of the form which was passed to Initialize(). The start
+   *  time and centre frequencies are those of the input.
+   *
+   * Only called on modules for which GetProfileRequest() returns true. The
+   * default implementation does nothing.
+   */
+  virtual void ProcessProfile(const SignalBank &profile);
+
+  /*! \brief Report whether this module can take its input through
+   *  ProcessScaled(). The default implementation returns false.
+   *
+   * A module which keeps its output as a buffer and a separate scale
+   * factor may pass both to such targets, and so avoid writing out the
+   * scaled output.
+   */
+  virtual bool AcceptsScaledInput() const;
+
+  /*! \brief Process an input given as a SignalBank of unscaled values.
+   *  \param input SignalBank of the form which was passed to Initialize()
+   *  \param scale Factor by which every sample of input is multiplied to
+   *  give the actual input. Each product must be formed as the sample is
+   *  read, so that the results are the same as from Process().
+   *
+   * Only called on modules for which AcceptsScaledInput() returns true. The
+   * default implementation does nothing.
+   */
+  virtual void ProcessScaled(const SignalBank &input, float scale);
+
   /*! \brief Reset the internal state of this module and all its children to
    *  their initial state.
    *
@@ -202,6 +272,17 @@ class Module {
  protected:
   void PushOutput();
 
+  /*! \brief Return true if the module has at least one target, and every
+   *  target only uses a profile of this module's output (see
+   *  GetProfileRequest()).
+   */
+  bool TargetsUseProfilesOnly() const;
+
+  /*! \brief Return true if the module has at least one target, and every
+   *  target accepts scaled input (see AcceptsScaledInput()).
+   */
+  bool TargetsAcceptScaledInput() const;
+
   virtual void ResetInternal() = 0;
 
   virtual bool InitializeInternal(const SignalBank &input) = 0;
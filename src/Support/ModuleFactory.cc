@@ -15,17 +15,22 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include "Modules/Features/ModuleDeltas.h"
 #include "Modules/Features/ModuleGaussians.h"
 //#include "Modules/Features/ModuleDCT.h"
 #include "Modules/BMM/ModuleGammatone.h"
 #include "Modules/BMM/ModulePZFC.h"
 #include "Modules/Input/ModuleFileInput.h"
 #include "Modules/NAP/ModuleHCL.h"
+#include "Modules/Output/FileOutputArchive.h"
+#include "Modules/Output/FileOutputNumpy.h"
 #include "Modules/Output/FileOutputHTK.h"
 #include "Modules/Output/FileOutputAIMC.h"
 #include "Modules/Output/FileOutputJSON.h"
 //#include "Modules/Output/OSCOutput.h"
 #include "Modules/Output/Graphics/GraphicsViewTime.h"
+#include "Modules/Profile/ModuleMultiSlice.h"
+#include "Modules/Profile/ModulePost.h"
 #include "Modules/Profile/ModuleSlice.h"
 #include "Modules/Profile/ModuleScaler.h"
 #include "Modules/SAI/ModuleSAI.h"
@@ -41,6 +46,9 @@ Module* ModuleFactory::Create(string module_name_, Parameters* params) {
   if (module_name_.compare("gaussians") == 0)
     return new ModuleGaussians(params);
 
+  if (module_name_.compare("deltas") == 0)
+    return new ModuleDeltas(params);
+
   //if (module_name_.compare("dct") == 0)
   //  return new ModuleDCT(params);
 
@@ -68,6 +76,12 @@ Module* ModuleFactory::Create(string module_name_, Parameters* params) {
   if (module_name_.compare("json_out") == 0)
     return new FileOutputJSON(params);
 
+  if (module_name_.compare("archive_out") == 0)
+    return new FileOutputArchive(params);
+
+  if (module_name_.compare("npy_out") == 0)
+    return new FileOutputNumpy(params);
+
   if (module_name_.compare("graphics_time") == 0)
     return new GraphicsViewTime(params);
 
@@ -77,6 +91,12 @@ Module* ModuleFactory::Create(string module_name_, Parameters* params) {
   if (module_name_.compare("slice") == 0)
     return new ModuleSlice(params);
 
+  if (module_name_.compare("multi_slice") == 0)
+    return new ModuleMultiSlice(params);
+
+  if (module_name_.compare("post") == 0)
+    return new ModulePost(params);
+
   if (module_name_.compare("weighted_sai") == 0)
     return new ModuleSAI(params);
 
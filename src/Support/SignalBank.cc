@@ -33,8 +33,10 @@ using std::vector;
 SignalBank::SignalBank() {
   sample_rate_ = 0.0f;
   start_time_ = 0;
+  pitch_index_ = -1;
   channel_count_ = 0;
   buffer_length_ = 0;
+  max_buffer_length_ = 0;
   initialized_ = false;
 }
 
@@ -52,13 +54,16 @@ bool SignalBank::Initialize(int channel_count,
     return false;
 
   start_time_ = 0;
+  pitch_index_ = -1;
   sample_rate_ = sample_rate;
   buffer_length_ = signal_length;
+  max_buffer_length_ = signal_length;
   channel_count_ = channel_count;
   signals_.resize(channel_count_);
   strobes_.resize(channel_count_);
   centre_frequencies_.resize(channel_count_, 0.0f);
   for (int i = 0; i < channel_count_; ++i) {
+    signals_[i].reserve(max_buffer_length_);
     signals_[i].resize(buffer_length_, 0.0f);
   }
   initialized_ = true;
@@ -74,8 +79,12 @@ bool SignalBank::Initialize(const SignalBank &input) {
     return false;
 
   start_time_ = input.start_time();
+  pitch_index_ = -1;
   sample_rate_ = input.sample_rate();
   buffer_length_ = input.buffer_length();
+  max_buffer_length_ = input.max_buffer_length();
+  if (max_buffer_length_ < buffer_length_)
+    max_buffer_length_ = buffer_length_;
   channel_count_ = input.channel_count();
 
   signals_.resize(channel_count_);
@@ -87,6 +96,7 @@ bool SignalBank::Initialize(const SignalBank &input) {
   }
 
   for (int i = 0; i < channel_count_; ++i) {
+    signals_[i].reserve(max_buffer_length_);
     signals_[i].resize(buffer_length_, 0.0f);
     strobes_[i].resize(0);
   }
@@ -94,6 +104,20 @@ bool SignalBank::Initialize(const SignalBank &input) {
   return true;
 }
 
+bool SignalBank::SetBufferLength(int buffer_length) {
+  if (!initialized_ || buffer_length < 1)
+    return false;
+  if (buffer_length == buffer_length_)
+    return true;
+  buffer_length_ = buffer_length;
+  if (max_buffer_length_ < buffer_length_)
+    max_buffer_length_ = buffer_length_;
+  for (int i = 0; i < channel_count_; ++i) {
+    signals_[i].resize(buffer_length_, 0.0f);
+  }
+  return true;
+}
+
 void SignalBank::Clear() {
   for (int i = 0; i < channel_count_; ++i) {
     signals_[i].assign(buffer_length_, 0.0f);
@@ -145,6 +169,10 @@ int SignalBank::buffer_length() const {
   return buffer_length_;
 }
 
+int SignalBank::max_buffer_length() const {
+  return max_buffer_length_;
+}
+
 int SignalBank::start_time() const {
   return start_time_;
 }
@@ -153,6 +181,14 @@ void SignalBank::set_start_time(int start_time) {
   start_time_ = start_time;
 }
 
+int SignalBank::pitch_index() const {
+  return pitch_index_;
+}
+
+void SignalBank::set_pitch_index(int pitch_index) {
+  pitch_index_ = pitch_index;
+}
+
 float SignalBank::centre_frequency(int i) const {
   if (i < channel_count_)
     return centre_frequencies_[i];
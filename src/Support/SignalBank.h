@@ -52,6 +52,15 @@ class SignalBank {
    * and centre frequencies as the input signal bank
    */
   bool Initialize(const SignalBank &input);
+
+  /* \brief Change the length of every signal in an initialized bank,
+   * keeping the channels, centre frequencies and strobes. Samples beyond the
+   * old length are zero. Does nothing if the length is unchanged, so modules
+   * whose input may vary in length can call it on every buffer. Lengths up
+   * to max_buffer_length() reuse the existing storage; a longer buffer
+   * raises the maximum.
+   */
+  bool SetBufferLength(int buffer_length);
   bool Validate() const;
 
   // Return a const reference to an individual signal. Allows for 
@@ -99,8 +108,22 @@ class SignalBank {
   void ResetStrobes(int channel);
   float sample_rate() const;
   int buffer_length() const;
+
+  // The largest buffer length the bank has storage for. This is the length
+  // given to Initialize(), or the maximum of the input bank when initialized
+  // from another SignalBank. buffer_length() is the number of valid samples
+  // in the current buffer.
+  int max_buffer_length() const;
   int start_time() const;
   void set_start_time(int start_time);
+
+  // Pitch of the current frame, as a lag in samples from the start of the
+  // frame, or -1 if no pitch estimate is available. Set by modules which
+  // estimate the pitch (such as the SSI), and passed on by modules which
+  // don't change the time axis, so that later modules and outputs can use
+  // it without repeating the estimate.
+  int pitch_index() const;
+  void set_pitch_index(int pitch_index);
   float centre_frequency(int i) const;
   void set_centre_frequency(int i, float cf);
   bool initialized() const;
@@ -109,11 +132,13 @@ class SignalBank {
  private:
   int channel_count_;
   int buffer_length_;
+  int max_buffer_length_;
   vector<vector<float> > signals_;
   vector<vector<int> > strobes_;
   vector<float> centre_frequencies_;
   float sample_rate_;
   int start_time_;
+  int pitch_index_;
   bool initialized_;
   DISALLOW_COPY_AND_ASSIGN(SignalBank);
 };
@@ -0,0 +1,142 @@
+// Copyright 2026, agent
+//
+// AIM-C: A C++ implementation of the Auditory Image Model
+// http://www.acousticscale.org/AIMC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*! \author agent <agent@local>
+ *  \date 2026/10/19
+ *  \version \$Id$
+ */
+
+#include "Support/Thread.h"
+
+namespace aimc {
+#ifdef _WINDOWS
+Mutex::Mutex() {
+  InitializeCriticalSection(&mutex_);
+}
+
+Mutex::~Mutex() {
+  DeleteCriticalSection(&mutex_);
+}
+
+void Mutex::Lock() {
+  EnterCriticalSection(&mutex_);
+}
+
+void Mutex::Unlock() {
+  LeaveCriticalSection(&mutex_);
+}
+
+ConditionVariable::ConditionVariable() {
+  InitializeConditionVariable(&condition_);
+}
+
+ConditionVariable::~ConditionVariable() {
+}
+
+void ConditionVariable::Wait(Mutex *mutex) {
+  SleepConditionVariableCS(&condition_, &mutex->mutex_, INFINITE);
+}
+
+void ConditionVariable::Broadcast() {
+  WakeAllConditionVariable(&condition_);
+}
+
+Thread::Thread() : thread_(NULL), running_(false) {
+}
+
+bool Thread::Start() {
+  if (running_)
+    return false;
+  thread_ = CreateThread(NULL, 0, &Thread::ThreadMain, this, 0, NULL);
+  running_ = (thread_ != NULL);
+  return running_;
+}
+
+void Thread::Join() {
+  if (!running_)
+    return;
+  WaitForSingleObject(thread_, INFINITE);
+  CloseHandle(thread_);
+  thread_ = NULL;
+  running_ = false;
+}
+
+DWORD WINAPI Thread::ThreadMain(LPVOID thread) {
+  reinterpret_cast<Thread*>(thread)->Run();
+  return 0;
+}
+#else
+Mutex::Mutex() {
+  pthread_mutex_init(&mutex_, NULL);
+}
+
+Mutex::~Mutex() {
+  pthread_mutex_destroy(&mutex_);
+}
+
+void Mutex::Lock() {
+  pthread_mutex_lock(&mutex_);
+}
+
+void Mutex::Unlock() {
+  pthread_mutex_unlock(&mutex_);
+}
+
+ConditionVariable::ConditionVariable() {
+  pthread_cond_init(&condition_, NULL);
+}
+
+ConditionVariable::~ConditionVariable() {
+  pthread_cond_destroy(&condition_);
+}
+
+void ConditionVariable::Wait(Mutex *mutex) {
+  pthread_cond_wait(&condition_, &mutex->mutex_);
+}
+
+void ConditionVariable::Broadcast() {
+  pthread_cond_broadcast(&condition_);
+}
+
+Thread::Thread() : running_(false) {
+}
+
+bool Thread::Start() {
+  if (running_)
+    return false;
+  running_ = (pthread_create(&thread_, NULL, &Thread::ThreadMain, this) == 0);
+  return running_;
+}
+
+void Thread::Join() {
+  if (!running_)
+    return;
+  pthread_join(thread_, NULL);
+  running_ = false;
+}
+
+void *Thread::ThreadMain(void *thread) {
+  reinterpret_cast<Thread*>(thread)->Run();
+  return NULL;
+}
+#endif
+
+Thread::~Thread() {
+  // Subclasses must stop and join their thread before they are destroyed,
+  // since Run() is no longer available by the time this runs.
+}
+}  // namespace aimc
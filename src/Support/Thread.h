@@ -0,0 +1,135 @@
+// Copyright 2026, agent
+//
+// AIM-C: A C++ implementation of the Auditory Image Model
+// http://www.acousticscale.org/AIMC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*! \file
+ *  \brief Minimal threading primitives, using pthreads or the Windows API
+ */
+
+/*! \author agent <agent@local>
+ *  \date 2026/10/19
+ *  \version \$Id$
+ */
+
+#ifndef AIMC_SUPPORT_THREAD_H_
+#define AIMC_SUPPORT_THREAD_H_
+
+#ifdef _WINDOWS
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#include "Support/Common.h"
+
+namespace aimc {
+class ConditionVariable;
+
+/*! \brief A mutual exclusion lock
+ */
+class Mutex {
+ public:
+  Mutex();
+  ~Mutex();
+  void Lock();
+  void Unlock();
+ private:
+  friend class ConditionVariable;
+#ifdef _WINDOWS
+  CRITICAL_SECTION mutex_;
+#else
+  pthread_mutex_t mutex_;
+#endif
+  DISALLOW_COPY_AND_ASSIGN(Mutex);
+};
+
+/*! \brief Holds a Mutex locked for the lifetime of the object
+ */
+class MutexLock {
+ public:
+  explicit MutexLock(Mutex *mutex) : mutex_(mutex) {
+    mutex_->Lock();
+  }
+  ~MutexLock() {
+    mutex_->Unlock();
+  }
+ private:
+  Mutex *mutex_;
+  DISALLOW_COPY_AND_ASSIGN(MutexLock);
+};
+
+/*! \brief A condition variable, for waiting on state guarded by a Mutex
+ */
+class ConditionVariable {
+ public:
+  ConditionVariable();
+  ~ConditionVariable();
+
+  /*! \brief Atomically unlock mutex and wait to be woken. The mutex is held
+   *  again on return. Wakeups may be spurious, so callers should re-check
+   *  the condition they are waiting for.
+   */
+  void Wait(Mutex *mutex);
+
+  /*! \brief Wake all waiting threads
+   */
+  void Broadcast();
+ private:
+#ifdef _WINDOWS
+  CONDITION_VARIABLE condition_;
+#else
+  pthread_cond_t condition_;
+#endif
+  DISALLOW_COPY_AND_ASSIGN(ConditionVariable);
+};
+
+/*! \brief A thread of execution. Subclasses implement Run().
+ */
+class Thread {
+ public:
+  Thread();
+  virtual ~Thread();
+
+  /*! \brief Start a new thread running Run()
+   *  \return true on success, false on failure.
+   */
+  bool Start();
+
+  /*! \brief Wait for Run() to return
+   */
+  void Join();
+
+  bool running() const {
+    return running_;
+  }
+
+ protected:
+  virtual void Run() = 0;
+
+ private:
+#ifdef _WINDOWS
+  static DWORD WINAPI ThreadMain(LPVOID thread);
+  HANDLE thread_;
+#else
+  static void *ThreadMain(void *thread);
+  pthread_t thread_;
+#endif
+  bool running_;
+  DISALLOW_COPY_AND_ASSIGN(Thread);
+};
+}  // namespace aimc
+
+#endif  // AIMC_SUPPORT_THREAD_H_
@@ -0,0 +1,104 @@
+// Copyright 2026, agent
+//
+// AIM-C: A C++ implementation of the Auditory Image Model
+// http://www.acousticscale.org/AIMC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*! \author agent <agent@local>
+ *  \date 2026/10/19
+ *  \version \$Id$
+ */
+
+#include "Support/WriterThread.h"
+
+namespace aimc {
+WriterThread::WriterThread(int queue_length)
+    : queue_length_(queue_length),
+      busy_(false),
+      stopping_(false) {
+  if (queue_length_ < 1) {
+    queue_length_ = 1;
+  }
+}
+
+WriterThread::~WriterThread() {
+  Stop();
+}
+
+void WriterThread::Enqueue(Job *job) {
+  if (!running() && !Start()) {
+    LOG_ERROR(_T("Couldn't start the output writer thread. Writing "
+                 "directly."));
+    job->Write();
+    delete job;
+    return;
+  }
+
+  MutexLock lock(&mutex_);
+  while (static_cast<int>(jobs_.size()) >= queue_length_) {
+    condition_.Wait(&mutex_);
+  }
+  jobs_.push_back(job);
+  condition_.Broadcast();
+}
+
+void WriterThread::WaitUntilIdle() {
+  MutexLock lock(&mutex_);
+  while (!jobs_.empty() || busy_) {
+    condition_.Wait(&mutex_);
+  }
+}
+
+void WriterThread::Stop() {
+  if (!running()) {
+    return;
+  }
+  {
+    MutexLock lock(&mutex_);
+    stopping_ = true;
+    condition_.Broadcast();
+  }
+  Join();
+  stopping_ = false;
+}
+
+void WriterThread::Run() {
+  while (true) {
+    Job *job;
+    {
+      MutexLock lock(&mutex_);
+      while (!stopping_ && jobs_.empty()) {
+        condition_.Wait(&mutex_);
+      }
+      // Everything queued before Stop() is still written
+      if (jobs_.empty()) {
+        return;
+      }
+      job = jobs_.front();
+      jobs_.pop_front();
+      busy_ = true;
+      condition_.Broadcast();
+    }
+
+    job->Write();
+    delete job;
+
+    {
+      MutexLock lock(&mutex_);
+      busy_ = false;
+      condition_.Broadcast();
+    }
+  }
+}
+}  // namespace aimc
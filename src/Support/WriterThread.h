@@ -0,0 +1,93 @@
+// Copyright 2026, agent
+//
+// AIM-C: A C++ implementation of the Auditory Image Model
+// http://www.acousticscale.org/AIMC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*! \file
+ *  \brief Background thread for blocking output operations
+ */
+
+/*! \author agent <agent@local>
+ *  \date 2026/10/19
+ *  \version \$Id$
+ */
+
+#ifndef AIMC_SUPPORT_WRITERTHREAD_H_
+#define AIMC_SUPPORT_WRITERTHREAD_H_
+
+#include <deque>
+
+#include "Support/Thread.h"
+
+namespace aimc {
+using std::deque;
+
+/*! \brief Runs output jobs, such as writes to disk, in order on a
+ *  background thread.
+ *
+ * The queue of waiting jobs is bounded: Enqueue() blocks while it is full,
+ * so a producer which outpaces the disk is held back rather than using
+ * unbounded memory.
+ */
+class WriterThread : public Thread {
+ public:
+  /*! \brief A unit of output. Each job is run once and then deleted.
+   */
+  class Job {
+   public:
+    virtual ~Job() {
+    }
+    virtual void Write() = 0;
+  };
+
+  /*! \param queue_length Maximum number of jobs waiting to be run
+   */
+  explicit WriterThread(int queue_length);
+
+  /*! \brief Runs any jobs still queued before returning
+   */
+  virtual ~WriterThread();
+
+  /*! \brief Queue a job, taking ownership of it. Blocks while the queue is
+   *  full. If the thread can't be started the job is run immediately.
+   */
+  void Enqueue(Job *job);
+
+  /*! \brief Wait until every job queued so far has finished
+   */
+  void WaitUntilIdle();
+
+  /*! \brief Finish the queued jobs, then stop the thread
+   */
+  void Stop();
+
+ protected:
+  virtual void Run();
+
+ private:
+  int queue_length_;
+
+  /*! \brief Everything below is guarded by mutex_
+   */
+  Mutex mutex_;
+  ConditionVariable condition_;
+  deque<Job*> jobs_;
+  bool busy_;
+  bool stopping_;
+  DISALLOW_COPY_AND_ASSIGN(WriterThread);
+};
+}  // namespace aimc
+
+#endif  // AIMC_SUPPORT_WRITERTHREAD_H_
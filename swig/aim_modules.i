@@ -26,6 +26,7 @@ namespace std {
 
 %{
 #include "Support/Common.h"
+#include "Support/FeatureArchive.h"
 #include "Support/Module.h"
 #include "Support/Parameters.h"
 #include "Support/SignalBank.h"
@@ -37,13 +38,17 @@ namespace std {
 #include "Modules/SAI/ModuleSAI.h"
 #include "Modules/SSI/ModuleSSI.h"
 #include "Modules/Profile/ModuleSlice.h"
+#include "Modules/Profile/ModuleMultiSlice.h"
 #include "Modules/Profile/ModuleScaler.h"
+#include "Modules/Profile/ModulePost.h"
 #include "Modules/Features/ModuleGaussians.h"
+#include "Modules/Features/ModuleDeltas.h"
 %}
 
 %include "Support/Parameters.h"
 using namespace std;
 %include "Support/SignalBank.h"
+%include "Support/FeatureArchive.h"
 
 namespace aimc {
 using std::ostream;
@@ -77,5 +82,8 @@ class Module {
 %include "Modules/SAI/ModuleSAI.h"
 %include "Modules/SSI/ModuleSSI.h"
 %include "Modules/Profile/ModuleSlice.h"
+%include "Modules/Profile/ModuleMultiSlice.h"
 %include "Modules/Profile/ModuleScaler.h"
+%include "Modules/Profile/ModulePost.h"
 %include "Modules/Features/ModuleGaussians.h"
+%include "Modules/Features/ModuleDeltas.h"
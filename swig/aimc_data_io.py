@@ -21,6 +21,13 @@ def readbin(type,file) :
 
 def read_aimc_data(filename):
     file = open(filename,'rb')
+    if file.read(4) == b'AIMC':
+        # Version 2 file
+        file.close()
+        v2 = read_aimc_v2(filename)
+        return (v2['data'], v2['frames'], v2['period'], v2['channels'],
+                v2['samples'], v2['sample_rate'])
+    file.seek(0)
         
     nFrames = readbin('i',file)[0]
     period = readbin( 'f', file)[0] # Frame period in ms
@@ -39,6 +46,60 @@ def read_aimc_data(filename):
     data = N.reshape(vec_data,(nFrames, nChannels, nSamples))
     return data, nFrames, period, nChannels, nSamples, sample_rate
 
+def read_aimc_v2(filename):
+    """
+    Read a version 2 .aimc file, as written by aimc_out with
+    aimc_out.format_version=2. Returns a dictionary of the header fields
+    and the sections of the file. The frames ('data', of shape
+    (frames, channels, samples)) and the other sections are memory-mapped,
+    so slicing them only reads the parts which are used.
+
+    The strobes of channel c of frame f are
+    strobe_values[strobe_rows[f * channels + c]:
+                  strobe_rows[f * channels + c + 1]]
+    """
+    file = open(filename, 'rb')
+    header = file.read(64)
+    file.close()
+    if len(header) < 64 or header[0:4] != b'AIMC':
+        raise IOError('%s is not a version 2 AIMC file' % filename)
+    (version, header_size, flags, nFrames, nChannels, nSamples,
+     sample_rate, period, compression, timestamps_offset,
+     frame_index_offset, strobes_offset) = unpack('<6I2fI3Q', header[4:])
+    if version != 2 or compression != 0:
+        raise IOError('Unsupported AIMC file version %d, compression %d'
+                      % (version, compression))
+
+    v2 = {'frames': nFrames, 'period': period, 'channels': nChannels,
+          'samples': nSamples, 'sample_rate': sample_rate}
+    if nFrames == 0:
+        v2['data'] = N.zeros((0, nChannels, nSamples), dtype=N.float32)
+        v2['timestamps'] = N.zeros(0, dtype=N.int64)
+        v2['frame_offsets'] = N.zeros(0, dtype=N.uint64)
+    else:
+        v2['data'] = N.memmap(filename, dtype=N.float32, mode='r',
+                              offset=header_size,
+                              shape=(nFrames, nChannels, nSamples))
+        v2['timestamps'] = N.memmap(filename, dtype=N.int64, mode='r',
+                                    offset=timestamps_offset,
+                                    shape=(nFrames,))
+        v2['frame_offsets'] = N.memmap(filename, dtype=N.uint64, mode='r',
+                                       offset=frame_index_offset,
+                                       shape=(nFrames,))
+    if flags & 1:
+        nRows = nFrames * nChannels + 1
+        rows = N.memmap(filename, dtype=N.uint64, mode='r',
+                        offset=strobes_offset, shape=(nRows,))
+        v2['strobe_rows'] = rows
+        nStrobes = int(rows[-1])
+        if nStrobes == 0:
+            v2['strobe_values'] = N.zeros(0, dtype=N.int32)
+        else:
+            v2['strobe_values'] = N.memmap(filename, dtype=N.int32, mode='r',
+                                           offset=strobes_offset + 8 * nRows,
+                                           shape=(nStrobes,))
+    return v2
+
 def write_aimc_data(filename, data, sample_rate, period = 0.0):
 
     nFrames, nChannels, nSamples = data.shape
@@ -57,3 +118,42 @@ def write_aimc_data(filename, data, sample_rate, period = 0.0):
 
     file.close()
     
+
+def read_feature_archive(path):
+    """
+    Open a feature archive written by the archive_out module, made up of
+    path.index and the shard files path.00000.shard, path.00001.shard...
+    Returns a dictionary from utterance id to an array of shape
+    (frames, channels, samples). The arrays are memory-mapped from the
+    shards, so only the frames which are used are read from disk.
+    """
+    index = open(path + '.index', 'r')
+    header = index.readline().rstrip('\n')
+    if header != '# AIM-C feature archive 1':
+        index.close()
+        raise IOError('%s.index is not a feature archive index' % path)
+
+    utterances = {}
+    shards = {}
+    for line in index:
+        line = line.rstrip('\n')
+        if not line or line.startswith('#'):
+            continue
+        fields = line.split('\t')
+        id = fields[0]
+        shard = int(fields[1])
+        offset = int(fields[2])
+        nFrames, nChannels, nSamples = [int(f) for f in fields[3:6]]
+        nData = nFrames * nChannels * nSamples
+        if nData == 0:
+            data = N.zeros((nFrames, nChannels, nSamples), dtype=N.float32)
+        else:
+            if shard not in shards:
+                shards[shard] = N.memmap('%s.%05d.shard' % (path, shard),
+                                         dtype=N.float32, mode='r')
+            start = offset // 4
+            data = shards[shard][start:start + nData]
+            data = data.reshape((nFrames, nChannels, nSamples))
+        utterances[id] = data
+    index.close()
+    return utterances
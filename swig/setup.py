@@ -25,11 +25,15 @@ from distutils.core import setup, Extension
 aimc_module = Extension('_aimc',
                         sources = ['aim_modules.i',
                                    '../src/Support/Common.cc',
+                                   '../src/Support/FeatureArchive.cc',
+                                   '../src/Support/FFT.cc',
+                                   '../src/Support/MappedFile.cc',
                                    '../src/Support/Parameters.cc',
                                    '../src/Support/SignalBank.cc', 
                                    '../src/Support/Module.cc',
                                    '../src/Modules/BMM/ModuleGammatone.cc',
                                    '../src/Modules/Features/ModuleGaussians.cc',
+                                   '../src/Modules/Features/ModuleDeltas.cc',
                                    '../src/Modules/BMM/ModulePZFC.cc',
                                    '../src/Modules/NAP/ModuleHCL.cc',
                                    '../src/Modules/Strobes/ModuleParabola.cc',
@@ -37,7 +41,9 @@ aimc_module = Extension('_aimc',
                                    '../src/Modules/SAI/ModuleSAI.cc',
                                    '../src/Modules/SSI/ModuleSSI.cc',
                                    '../src/Modules/Profile/ModuleSlice.cc',
-                                   '../src/Modules/Profile/ModuleScaler.cc'],
+                                   '../src/Modules/Profile/ModuleMultiSlice.cc',
+                                   '../src/Modules/Profile/ModuleScaler.cc',
+                                   '../src/Modules/Profile/ModulePost.cc'],
                         swig_opts = ['-c++','-I../src/'], 
                         include_dirs=['../src/', '/opt/local/include/']
                         )